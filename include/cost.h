@@ -0,0 +1,77 @@
+#pragma once
+
+#include "rational.h"
+#include "json.hpp"
+#ifdef DOUBLE_COSTS
+#include <limits>
+#endif
+
+namespace ratio
+{
+#ifdef DOUBLE_COSTS
+  /**
+   * @brief The type of the estimated costs of flaws and resolvers.
+   *
+   * Heuristic estimates do not need exact arithmetic, hence, when the `DOUBLE_COSTS` option is enabled, they are represented as floating-point numbers, saving the normalization of rational numbers on every sum and comparison. Infinite costs are represented by the floating-point infinities.
+   */
+  using cost_t = double;
+
+  inline cost_t zero_cost() noexcept { return 0; }
+  inline cost_t positive_infinite_cost() noexcept { return std::numeric_limits<double>::infinity(); }
+  inline cost_t negative_infinite_cost() noexcept { return -std::numeric_limits<double>::infinity(); }
+
+  inline bool is_positive_infinite(const cost_t &c) noexcept { return c == std::numeric_limits<double>::infinity(); }
+  inline bool is_negative_infinite(const cost_t &c) noexcept { return c == -std::numeric_limits<double>::infinity(); }
+  inline bool is_infinite(const cost_t &c) noexcept { return is_positive_infinite(c) || is_negative_infinite(c); }
+
+  /**
+   * @brief Converts the given (intrinsic) rational cost into a cost.
+   *
+   * @param c the rational cost.
+   * @return cost_t the converted cost.
+   */
+  inline cost_t to_cost(const utils::rational &c) noexcept
+  {
+    if (utils::is_positive_infinite(c))
+      return positive_infinite_cost();
+    else if (utils::is_negative_infinite(c))
+      return negative_infinite_cost();
+    return static_cast<double>(c.numerator()) / static_cast<double>(c.denominator());
+  }
+
+  /**
+   * @brief Gets a json representation of the given cost, using the same format of the rational numbers.
+   *
+   * @param c the cost.
+   * @return json::json the json representation of the cost.
+   */
+  inline json::json to_json(const cost_t &c) noexcept
+  {
+    json::json j_c;
+    if (is_infinite(c))
+    {
+      j_c["num"] = is_positive_infinite(c) ? 1 : -1;
+      j_c["den"] = 0;
+    }
+    else
+    {
+      j_c["num"] = c;
+      j_c["den"] = 1;
+    }
+    return j_c;
+  }
+#else
+  /**
+   * @brief The type of the estimated costs of flaws and resolvers.
+   *
+   * By default, costs are represented exactly, as rational numbers.
+   */
+  using cost_t = utils::rational;
+
+  inline cost_t zero_cost() noexcept { return utils::rational::ZERO; }
+  inline cost_t positive_infinite_cost() noexcept { return utils::rational::POSITIVE_INFINITY; }
+  inline cost_t negative_infinite_cost() noexcept { return utils::rational::NEGATIVE_INFINITY; }
+
+  inline const cost_t &to_cost(const utils::rational &c) noexcept { return c; }
+#endif
+} // namespace ratio
@@ -2,8 +2,11 @@
 
 #include "lit.h"
 #include "rational.h"
+#include "cost.h"
 #include "json.hpp"
 #include "memory.h"
+#include "memory_pool.h"
+#include "small_vector.h"
 #include <vector>
 #include <functional>
 
@@ -26,6 +29,9 @@ namespace ratio
     flaw(solver &s, std::vector<std::reference_wrapper<resolver>> causes, const bool &exclusive = false);
     virtual ~flaw() = default;
 
+    static void *operator new(size_t size) { return memory_pool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept { memory_pool::deallocate(ptr, size); }
+
     /**
      * @brief Get the solver this flaw belongs to.
      *
@@ -43,30 +49,30 @@ namespace ratio
     /**
      * @brief Get the resolvers that caused this flaw.
      *
-     * @return std::vector<std::reference_wrapper<resolver>>& The resolvers that caused this flaw.
+     * @return small_vector<std::reference_wrapper<resolver>, 4>& The resolvers that caused this flaw.
      */
-    std::vector<std::reference_wrapper<resolver>> &get_causes() noexcept { return causes; }
+    small_vector<std::reference_wrapper<resolver>, 4> &get_causes() noexcept { return causes; }
 
     /**
      * @brief Get the resolvers that caused this flaw.
      *
-     * @return const std::vector<std::reference_wrapper<resolver>>& The resolvers that caused this flaw.
+     * @return const small_vector<std::reference_wrapper<resolver>, 4>& The resolvers that caused this flaw.
      */
-    const std::vector<std::reference_wrapper<resolver>> &get_causes() const noexcept { return causes; }
+    const small_vector<std::reference_wrapper<resolver>, 4> &get_causes() const noexcept { return causes; }
 
     /**
      * @brief Get the resolvers that supported by this flaw.
      *
-     * @return std::vector<std::reference_wrapper<resolver>>& The resolvers that supported by this flaw.
+     * @return small_vector<std::reference_wrapper<resolver>, 4>& The resolvers that supported by this flaw.
      */
-    std::vector<std::reference_wrapper<resolver>> &get_supports() noexcept { return supports; }
+    small_vector<std::reference_wrapper<resolver>, 4> &get_supports() noexcept { return supports; }
 
     /**
      * @brief Gets the estimated cost of this flaw.
      *
-     * @return const utils::rational& the estimated cost of this flaw.
+     * @return const cost_t& the estimated cost of this flaw.
      */
-    utils::rational get_estimated_cost() const noexcept { return est_cost; }
+    const cost_t &get_estimated_cost() const noexcept { return est_cost; }
 
     /**
      * @brief Check whether this flaw has been expanded.
@@ -84,22 +90,30 @@ namespace ratio
     const semitone::lit &get_phi() const noexcept { return phi; }
 
     /**
-     * @brief Get the position variable associated to this flaw.
+     * @brief Get the position associated to this flaw, i.e., its node in the topological order, if TOPOLOGICAL_ORDERING is defined, or its integer time-point otherwise.
      *
-     * @return const semitone::var& The position variable.
+     * @return const semitone::var& The position of this flaw.
      */
     const semitone::var &get_position() const noexcept { return position; }
 
     /**
      * @brief Get the resolvers for solving this flaw.
      *
-     * @return std::vector<std::reference_wrapper<resolver>>& The resolvers.
+     * @return small_vector<std::reference_wrapper<resolver>, 4>& The resolvers.
+     */
+    small_vector<std::reference_wrapper<resolver>, 4> &get_resolvers() noexcept { return resolvers; }
+    /**
+     * @brief Get the resolvers for solving this flaw.
+     *
+     * @return const small_vector<std::reference_wrapper<resolver>, 4>& The resolvers.
      */
-    std::vector<std::reference_wrapper<resolver>> &get_resolvers() noexcept { return resolvers; }
+    const small_vector<std::reference_wrapper<resolver>, 4> &get_resolvers() const noexcept { return resolvers; }
 
     /**
      * @brief Gets the cheapest resolver of this flaw.
      *
+     * The cheapest resolver is maintained by the solver as the costs of the resolvers change.
+     *
      * @return resolver& the cheapest resolver of this flaw.
      */
     resolver &get_cheapest_resolver() const noexcept;
@@ -145,14 +159,15 @@ namespace ratio
 
   private:
     solver &s;                                                     // the solver this flaw belongs to..
-    std::vector<std::reference_wrapper<resolver>> causes;          // the resolvers that caused this flaw..
-    const bool exclusive;                                          // whether this flaw is exclusive or not..
+    cost_t est_cost = positive_infinite_cost();                    // the current estimated cost of the flaw..
     semitone::lit phi;                                             // the literal indicating whether the flaw is active or not (this literal is initialized by the `init` procedure)..
-    utils::rational est_cost = utils::rational::POSITIVE_INFINITY; // the current estimated cost of the flaw..
-    semitone::var position;                                        // the position variable (i.e., an integer time-point) associated to this flaw..
     bool expanded = false;                                         // whether this flaw has been expanded or not..
-    std::vector<std::reference_wrapper<resolver>> resolvers;       // the resolvers for this flaw..
-    std::vector<std::reference_wrapper<resolver>> supports;        // the resolvers supported by this flaw (used for propagating cost estimates)..
+    resolver *cheapest = nullptr;                                  // the cheapest resolver of the flaw..
+    const bool exclusive;                                          // whether this flaw is exclusive or not..
+    semitone::var position;                                        // the position of this flaw (i.e., a node of the topological order, if TOPOLOGICAL_ORDERING is defined, an integer time-point otherwise)..
+    small_vector<std::reference_wrapper<resolver>, 4> causes;      // the resolvers that caused this flaw..
+    small_vector<std::reference_wrapper<resolver>, 4> resolvers;   // the resolvers for this flaw..
+    small_vector<std::reference_wrapper<resolver>, 4> supports;    // the resolvers supported by this flaw (used for propagating cost estimates)..
   };
 
   using flaw_ptr = utils::u_ptr<flaw>;
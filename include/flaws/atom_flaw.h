@@ -7,6 +7,7 @@
 namespace ratio
 {
   class smart_type;
+  class atom;
 
   class atom_flaw final : public flaw
   {
@@ -20,9 +21,29 @@ namespace ratio
 
   private:
     void compute_resolvers() override;
+    std::vector<resolver_ptr> compute_unifications(flaw &f, std::vector<atom *> targets); // computes the unification resolvers of the `f` flaw (i.e., either this flaw or one of its overflow flaws) towards the given candidate targets..
 
     json::json get_data() const noexcept override;
 
+    /**
+     * @brief A flaw for unifying the atom with the unification targets exceeding the unification cap.
+     *
+     */
+    class unification_overflow final : public flaw
+    {
+    public:
+      unification_overflow(solver &s, std::vector<std::reference_wrapper<resolver>> causes, atom_flaw &af, std::vector<atom *> targets);
+
+    private:
+      void compute_resolvers() override;
+
+      json::json get_data() const noexcept override;
+
+    private:
+      atom_flaw &af;               // the atom flaw whose unifications are being considered..
+      std::vector<atom *> targets; // the remaining unification targets..
+    };
+
     class activate_fact final : public resolver
     {
     public:
@@ -48,19 +69,42 @@ namespace ratio
     class unify_atom final : public resolver
     {
     public:
-      unify_atom(atom_flaw &ef, riddle::expr target, const semitone::lit &unif_lit);
+      unify_atom(flaw &f, atom_flaw &af, riddle::expr target, const semitone::lit &unif_lit);
 
       void apply() override;
 
       json::json get_data() const noexcept override;
 
     private:
+      atom_flaw &af; // the atom flaw of the atom to unify..
       riddle::expr target;
       semitone::lit unif_lit;
     };
 
+    class unify_overflow final : public resolver
+    {
+    public:
+      unify_overflow(flaw &f, atom_flaw &af, std::vector<atom *> targets);
+
+      void apply() override;
+
+      json::json get_data() const noexcept override;
+
+    private:
+      atom_flaw &af;               // the atom flaw of the atom to unify..
+      std::vector<atom *> targets; // the unification targets exceeding the unification cap..
+    };
+
   public:
     static bool is_unification(const resolver &r) noexcept { return dynamic_cast<const unify_atom *>(&r) != nullptr; }
+    /**
+     * @brief Checks whether the given flaw can have unification resolvers (i.e., whether it is either an atom flaw or one of its unification overflow flaws).
+     *
+     * @param f the flaw to check.
+     * @return true if the resolvers of the given flaw might include unifications.
+     * @return false otherwise.
+     */
+    static bool is_unifying(const flaw &f) noexcept { return dynamic_cast<const atom_flaw *>(&f) || dynamic_cast<const unification_overflow *>(&f); }
 
   private:
     riddle::expr atm;
@@ -19,6 +19,15 @@ namespace ratio
   class flaw;
   class resolver;
 
+  /**
+   * @brief Exception thrown when the causal graph exceeds its budget (i.e., the maximum number of expanded flaws, the maximum number of resolvers or the maximum size, as flaws, resolvers and causal links) without providing an estimated solution.
+   */
+  class budget_exceeded_exception : public std::exception
+  {
+  public:
+    const char *what() const noexcept override { return "the causal graph budget has been exceeded"; }
+  };
+
   class graph
   {
     friend class solver;
@@ -30,9 +39,26 @@ namespace ratio
     solver &get_solver() const noexcept { return s; }
     const semitone::var &get_gamma() const noexcept { return gamma; }
 
+    /**
+     * @brief Checks whether the graph has exceeded its budget, in which case it is not expanded anymore.
+     *
+     * @return true If the graph has exceeded its budget.
+     */
+    bool is_exhausted() const noexcept { return exhausted; }
+
   private:
     void reset_gamma();
 
+    /**
+     * @brief Builds the graph or, if `layer` is true, adds a layer to it.
+     *
+     * If the budget is exceeded, the graph is not expanded anymore and the search proceeds on the current graph, provided that it has an estimated solution.
+     *
+     * @param layer Whether a layer has to be added to the current graph.
+     * @throws budget_exceeded_exception If the budget is exceeded and the current graph has no estimated solution.
+     */
+    void grow(const bool &layer = false);
+
     void check();
 
     /**
@@ -73,29 +99,102 @@ namespace ratio
     virtual void refine() {}
 #endif
 
+#ifdef LAZY_GRAPH
+    /**
+     * @brief Checks whether the causal subgraph supporting the given flaw has some unexpanded flaw.
+     *
+     * @param f The flaw to check.
+     * @return true If the causal subgraph supporting the given flaw can be further expanded.
+     */
+    virtual bool is_expandable(flaw &) { return false; }
+    /**
+     * @brief Expands, in best-first order, the causal subgraph supporting the given flaw until the flaw gets a finite estimated cost.
+     *
+     * @param f The flaw whose supporting subgraph has to be expanded.
+     * @pre the solver must be at root-level.
+     */
+    virtual void expand_subgraph(flaw &) {}
+#endif
+
+    /**
+     * @brief Selects, among the active flaws, the next flaw to be solved.
+     *
+     * By default, the most expensive flaw is selected.
+     *
+     * @return flaw& The next flaw to be solved.
+     * @pre there must be at least one active flaw.
+     */
+    virtual flaw &select_flaw();
+    /**
+     * @brief Selects the resolver to be applied for solving the given flaw.
+     *
+     * By default, the best resolver of the flaw is selected.
+     *
+     * @param f The flaw to be solved.
+     * @return resolver& The resolver to be applied.
+     * @pre the given flaw must have a finite estimated cost.
+     */
+    virtual resolver &select_resolver(flaw &f) { return f.get_best_resolver(); }
+
     virtual void push() {}
     virtual void pop() {}
 
   protected:
-    virtual void activated_flaw(flaw &) {}
+    virtual void activated_flaw(flaw &f) { invalidate_deferrable(f); }
     virtual void negated_flaw(flaw &f) { propagate_costs(f); }
-    virtual void activated_resolver(resolver &) {}
+    virtual void activated_resolver(resolver &r) { invalidate_deferrable(r.get_flaw()); }
     virtual void negated_resolver(resolver &r);
 
     void new_flaw(flaw_ptr f, const bool &enqueue = true) const noexcept;
-    const std::unordered_map<semitone::var, std::vector<flaw_ptr>> &get_flaws() const noexcept;
+    const std::vector<std::vector<flaw_ptr>> &get_flaws() const noexcept;
     const std::unordered_set<flaw *> &get_active_flaws() const noexcept;
-    const std::unordered_map<semitone::var, std::vector<resolver_ptr>> &get_resolvers() const noexcept;
+    const std::vector<std::vector<resolver_ptr>> &get_resolvers() const noexcept;
     void expand_flaw(flaw &f);
+    /**
+     * @brief Checks whether the graph can be further expanded without exceeding its budget.
+     *
+     * @throws budget_exceeded_exception If the budget has been exceeded.
+     */
+    void check_budget() const;
+
+    void set_cost(flaw &f, const cost_t &cost) noexcept;
+    /**
+     * @brief Gets the cost the given flaw should have, according to the current cost of its best resolver.
+     *
+     * @param f The flaw to get the cost of.
+     * @return cost_t The cost of the flaw, which is infinite if the flaw is negated.
+     */
+    cost_t get_cost(const flaw &f) const noexcept;
 
-    void set_cost(flaw &f, const utils::rational &cost) const noexcept;
+    /**
+     * @brief Invalidates the memoized deferrability of the given flaw and of the flaws whose deferrability depends on it (i.e., the flaws which support, directly or indirectly, the given flaw).
+     *
+     * @param f The flaw whose deferrability might have changed.
+     */
+    void invalidate_deferrable(flaw &f);
 
     std::vector<std::vector<std::pair<semitone::lit, double>>> get_incs() const noexcept;
 
+    /**
+     * @brief Probes, in the given order, the given literals, learning the negation of those which turn out to be inconsistent.
+     *
+     * Literals which get a value while probing the previous ones are not probed. The probes are run one after the other, at root-level, on the solver's own SAT core.
+     *
+     * @param lits The literals to probe.
+     * @return true if some of the literals turned out to be inconsistent.
+     */
+    bool probe(const std::vector<semitone::lit> &lits);
+
   protected:
-    solver &s; // The solver this graph belongs to.
+    solver &s;                                   // The solver this graph belongs to.
+    std::unordered_map<const flaw *, bool> defs; // The memoized deferrability of the flaws, for the current building round..
+    size_t n_learnt = 0;                         // The number of literals learnt by probing..
   private:
-    semitone::var gamma; // The variable representing the validity of this graph..
+    semitone::var gamma;    // The variable representing the validity of this graph..
+    size_t n_flaws = 0;     // The number of expanded flaws..
+    size_t n_resolvers = 0; // The number of resolvers of the expanded flaws..
+    size_t size = 0;        // The size of the graph, as the number of the expanded flaws, of their resolvers and of the causal links to the resolvers' preconditions..
+    bool exhausted = false; // Whether the budget has been exceeded..
   };
 
   using graph_ptr = utils::u_ptr<graph>;
@@ -9,11 +9,34 @@ namespace ratio
   class enum_flaw;
   class atom_flaw;
 
-  class h_1 final : public graph
+  class h_1 : public graph
   {
   public:
     h_1(solver &s);
 
+  protected:
+#ifdef GRAPH_REFINING
+    /**
+     * @brief Notifies that the given atom flaw has been found to be a landmark (i.e., that it must be solved in any solution of the current graph).
+     *
+     * @param l The found landmark.
+     */
+    virtual void new_landmark(atom_flaw &) {}
+#endif
+
+    /**
+     * @brief Checks the causal graph at the end of each expansion round of the building procedures, before the inconsistencies are extracted.
+     */
+    virtual void check_round() {}
+
+    /**
+     * @brief Expands the given flaw, within the budget of the graph, collecting the enum flaws and the possible landmarks.
+     *
+     * @param f The flaw to expand.
+     * @throws budget_exceeded_exception If the budget has been exceeded.
+     */
+    void expand(flaw &f);
+
   private:
     void enqueue(flaw &f) override;
 
@@ -21,6 +44,8 @@ namespace ratio
 
     void build() override;
     void add_layer() override;
+    cost_t get_priority(const flaw &f) const noexcept; // returns the expansion priority of the given flaw..
+    void clean_queue();                                // removes the expanded (and the negated) flaws from the flaw queue, forgetting their priorities..
 
 #ifdef GRAPH_PRUNING
     void prune() override;
@@ -31,17 +56,29 @@ namespace ratio
     void prune_enums();
 #endif
 
+#ifdef LAZY_GRAPH
+    bool is_expandable(flaw &f) override;
+    void expand_subgraph(flaw &f) override;
+    std::vector<flaw *> get_unexpanded(flaw &f); // returns the unexpanded (and not negated) flaws of the causal subgraph supporting the given flaw..
+#endif
+
     bool is_deferrable(flaw &f); // checks whether the given flaw is deferrable..
 
+  protected:
+    std::deque<flaw *> flaw_q; // the flaw queue (for the graph building procedure)..
+
   private:
-    std::deque<flaw *> flaw_q;          // the flaw queue (for the graph building procedure)..
-    std::unordered_set<flaw *> visited; // the visited flaws, for graph cost propagation (and deferrable flaws check)..
+    std::unordered_map<const flaw *, cost_t> priorities; // the expansion priorities of the enqueued flaws..
 #ifdef GRAPH_PRUNING
-    std::unordered_set<flaw *> already_closed; // already closed flaws (for avoiding duplicating graph pruning constraints)..
+    std::unordered_map<flaw *, semitone::var> already_closed; // already closed flaws, with the graph variable they have been closed for (for avoiding duplicating graph pruning constraints)..
+#ifdef LAZY_GRAPH
+    bool open_frontier = false; // whether the unexpanded flaws are left open for the current graph variable, since the graph expanded so far has no solution..
+#endif
 #endif
 #ifdef GRAPH_REFINING
-    std::vector<enum_flaw *> enum_flaws;       // the enum flaws..
-    std::unordered_set<atom_flaw *> landmarks; // the possible landmarks..
+    std::vector<enum_flaw *> enum_flaws;                                     // the enum flaws..
+    std::unordered_map<enum_flaw *, std::pair<size_t, size_t>> probed_enums; // the number of decided resolvers and of learnt literals when the enum flaws have been last probed..
+    std::unordered_set<atom_flaw *> landmarks;                               // the possible landmarks..
 #endif
   };
 } // namespace ratio
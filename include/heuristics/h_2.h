@@ -1,37 +1,16 @@
 #pragma once
 
-#include "graph.h"
-#include <deque>
-#include <unordered_set>
+#include "h_1.h"
 
 namespace ratio
 {
-  class enum_flaw;
-  class atom_flaw;
-
-  class h_2 : public graph
+  class h_2 : public h_1
   {
   public:
     h_2(solver &s);
 
   private:
-    void enqueue(flaw &f) override;
-
-    void propagate_costs(flaw &f) override;
-
-    void build() override;
-    void add_layer() override;
-
-#ifdef GRAPH_PRUNING
-    void prune() override;
-#endif
-
-#ifdef GRAPH_REFINING
-    void refine() override;
-    void prune_enums();
-#endif
-
-    void check();
+    void check_round() override; // checks the graph for mutexes, expanding the flaws which turn out to be required..
 
     /**
      * @brief Visits the given flaw, returning whether there is an estimated solution for it.
@@ -41,7 +20,14 @@ namespace ratio
      */
     bool visit(flaw &f);
 
+    void activated_flaw(flaw &f) override;
+    void negated_flaw(flaw &f) override;
+    void activated_resolver(resolver &r) override;
     void negated_resolver(resolver &r) override;
+    void invalidate_checked() noexcept; // forgets the checked flaws, if the root-level facts have changed..
+
+    bool is_mutex(const semitone::lit &r0, const semitone::lit &r1) const noexcept; // checks whether the `r1` rho literal is mutex with the `r0` rho literal..
+    void add_mutex(const semitone::lit &r0, const semitone::lit &r1);               // makes the `r1` rho literal mutex with the `r0` rho literal..
 
     class h_2_flaw : public flaw
     {
@@ -71,22 +57,13 @@ namespace ratio
       resolver &mtx_r;
     };
 
-    bool is_deferrable(flaw &f); // checks whether the given flaw is deferrable..
-
   private:
-    std::deque<flaw *> flaw_q;          // the flaw queue (for the graph building procedure)..
-    std::unordered_set<flaw *> visited; // the visited flaws, for graph cost propagation (and deferrable flaws check)..
-#ifdef GRAPH_PRUNING
-    std::unordered_set<flaw *> already_closed; // already closed flaws (for avoiding duplicating graph pruning constraints)..
-#endif
-#ifdef GRAPH_REFINING
-    std::vector<enum_flaw *> enum_flaws;       // the enum flaws..
-    std::unordered_set<atom_flaw *> landmarks; // the possible landmarks..
-#endif
-
-    resolver *c_res = nullptr;                                              // the current resolver..
-    std::vector<flaw *> h_2_flaws;                                          // the h_2 flaws..
-    std::unordered_set<flaw *> pending_flaws;                               // the pending flaws (to add in case adding a layer is required)..
-    std::unordered_map<resolver *, std::unordered_set<resolver *>> mutexes; // the mutexes..
+    std::unordered_set<flaw *> visited;                                  // the visited flaws, for the mutex check..
+    resolver *c_res = nullptr;                                           // the current resolver..
+    std::vector<flaw *> h_2_flaws;                                       // the h_2 flaws..
+    std::unordered_set<flaw *> pending_flaws;                            // the pending flaws (to add in case adding a layer is required)..
+    std::vector<std::vector<size_t>> mutexes;                            // the mutexes, indexed by the rho literals of the resolvers, as sorted adjacency lists of rho literals..
+    std::vector<std::pair<semitone::lit, semitone::lit>> new_mutexes;    // the mutexes found by the current check, to be pruned at root-level..
+    std::unordered_map<const flaw *, std::pair<cost_t, size_t>> checked; // the flaws found solvable by the last check, with their estimated cost and their number of resolvers at that time (cleared whenever a flaw or a resolver gets a value at root-level)..
   };
 } // namespace ratio
\ No newline at end of file
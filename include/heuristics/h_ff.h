@@ -0,0 +1,54 @@
+#pragma once
+
+#include "h_1.h"
+
+namespace ratio
+{
+  /**
+   * @brief A relaxed-plan (FF-style) heuristic.
+   *
+   * The causal graph is built, and the costs are propagated, as in the additive heuristic. Search decisions, however, are guided by the relaxed plans extracted from the causal graph, following the best resolvers of the flaws, in which shared subgoals are counted once. The relaxed plans of the active flaws are extracted once for each state of the graph, and reused until a flaw or a resolver changes its state or the solver backtracks.
+   *
+   * Notice that the estimated costs of the flaws and of the resolvers remain the additive ones: the solver requires the estimated cost of each flaw to be the one of its best resolver, which the costs of the relaxed plans, sharing subgoals among the resolvers, do not guarantee. The relaxed plans, hence, affect which flaw is selected and how it is solved, but not the costs the causal graph is built and pruned with.
+   */
+  class h_ff final : public h_1
+  {
+  public:
+    h_ff(solver &s);
+
+  private:
+    flaw &select_flaw() override;
+    resolver &select_resolver(flaw &f) override;
+
+    void push() override;
+    void pop() override;
+
+    void activated_flaw(flaw &f) override;
+    void negated_flaw(flaw &f) override;
+    void activated_resolver(resolver &r) override;
+    void negated_resolver(resolver &r) override;
+
+    /**
+     * @brief Extracts, unless they are still valid, the relaxed plans of the active flaws.
+     */
+    void extract_plans();
+
+    /**
+     * @brief Extracts the relaxed plan for applying the given resolver, adding its resolvers to the given plan.
+     *
+     * Resolvers which are already in the given plan, or in the given shared plan, are not counted again.
+     *
+     * @param r The resolver to be applied.
+     * @param plan The plan to which the resolvers of the relaxed plan are added.
+     * @param shared An optional plan whose resolvers are considered as already applied.
+     * @return cost_t The cost of the resolvers added to the plan.
+     */
+    cost_t extract_plan(resolver &r, std::unordered_set<const resolver *> &plan, const std::unordered_set<const resolver *> *shared = nullptr) const;
+    bool is_solved(flaw &f) const noexcept; // checks whether the given flaw has already been solved (i.e., whether one of its resolvers has been applied)..
+
+  private:
+    bool valid_plans = false;                                                                       // whether the relaxed plans of the active flaws are still valid..
+    std::unordered_map<const flaw *, std::pair<std::unordered_set<const resolver *>, cost_t>> plans; // the relaxed plans of the (solvable) active flaws, with their costs..
+    std::unordered_map<const resolver *, size_t> n_plans;                                           // for each resolver, the number of relaxed plans of the active flaws containing it..
+  };
+} // namespace ratio
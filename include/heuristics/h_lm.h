@@ -0,0 +1,46 @@
+#pragma once
+
+#include "h_1.h"
+
+namespace ratio
+{
+  /**
+   * @brief A landmark-count heuristic.
+   *
+   * The causal graph is built, and the costs are propagated, as in the max heuristic. The landmarks found while refining the causal graph are ordered and flaw selection is biased toward the flaws whose causal subgraph contains the earliest landmark not yet achieved and, then, the most landmarks not yet achieved. Without graph refinement no landmark is found, and flaws are selected as in the max heuristic.
+   */
+  class h_lm final : public h_1
+  {
+  public:
+    h_lm(solver &s);
+
+  private:
+#ifdef GRAPH_REFINING
+    void new_landmark(atom_flaw &l) override;
+#endif
+
+    flaw &select_flaw() override;
+
+    void push() override;
+    void pop() override;
+
+    void activated_flaw(flaw &f) override;
+    void negated_flaw(flaw &f) override;
+    void activated_resolver(resolver &r) override;
+    void negated_resolver(resolver &r) override;
+
+    /**
+     * @brief Computes, unless it is still valid, which unachieved landmarks are contained in the causal subgraph of each flaw.
+     *
+     * The causal graph is climbed once from each unachieved landmark, following the best resolvers backward, rather than being visited once for each active flaw.
+     */
+    void compute_supports();
+
+    bool is_achieved(const atom_flaw &l) const noexcept; // checks whether the given landmark is achieved (i.e., either not required anymore or solved)..
+
+  private:
+    std::vector<atom_flaw *> lms;                                            // the found landmarks, ordered by increasing estimated cost when found..
+    bool valid_supports = false;                                             // whether the landmark supports of the flaws are still valid..
+    std::unordered_map<const flaw *, std::pair<size_t, size_t>> lm_supports; // for each flaw, the position of the earliest unachieved landmark and the number of unachieved landmarks in its causal subgraph..
+  };
+} // namespace ratio
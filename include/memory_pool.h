@@ -0,0 +1,44 @@
+#pragma once
+
+#include "oratiosolver_export.h"
+#include <cstddef>
+
+namespace ratio
+{
+  /**
+   * @brief A pool of small memory blocks, used for allocating the (many) flaws and resolvers created by the solver.
+   *
+   * Each thread has its own pool, so that no synchronization is required. Blocks are carved, for each size class, out of large chunks of memory, and released blocks are recycled through per-size free lists. The chunks are returned to the system all at once when the last solver of the thread is destroyed, rather than block by block. As a consequence, the objects allocated through the pool must not outlive their solver and must be released by the thread which created them. This holds for the flaws and the resolvers, which are owned by the solver, but not for the items, which are reference counted expressions that can be shared beyond the lifetime of the solver and are hence allocated through the global allocator.
+   */
+  class memory_pool
+  {
+  public:
+    /**
+     * @brief Allocates a block of at least the given size.
+     *
+     * @param size the size of the requested block.
+     * @return void* the allocated block.
+     */
+    ORATIOSOLVER_EXPORT static void *allocate(const size_t &size);
+    /**
+     * @brief Releases a block previously allocated through `allocate` with the same size.
+     *
+     * @param ptr the block to release.
+     * @param size the size the block was allocated with.
+     */
+    ORATIOSOLVER_EXPORT static void deallocate(void *ptr, const size_t &size) noexcept;
+
+    /**
+     * @brief A user of the pool of the current thread.
+     *
+     * The chunks of the pool are released when the last user of the thread is destroyed. The solver inherits from this class, as its first base, so that the chunks are released only after all the members and bases of the solver, and hence all the objects allocated through the pool, have been destroyed.
+     */
+    class user
+    {
+    public:
+      ORATIOSOLVER_EXPORT user() noexcept;
+      user(const user &) = delete;
+      ORATIOSOLVER_EXPORT ~user();
+    };
+  };
+} // namespace ratio
@@ -25,6 +25,9 @@ namespace ratio
     resolver(flaw &f, const semitone::lit &rho, const utils::rational &cost);
     virtual ~resolver() = default;
 
+    static void *operator new(size_t size) { return memory_pool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept { memory_pool::deallocate(ptr, size); }
+
     /**
      * @brief Get the solver this resolver belongs to.
      *
@@ -69,16 +72,18 @@ namespace ratio
     /**
      * @brief Gets the estimated cost of this resolver.
      *
-     * @return const utils::rational& the estimated cost of this resolver.
+     * The cost is maintained by the solver, which updates it whenever the resolver is negated or the costs of its preconditions change.
+     *
+     * @return const cost_t& the estimated cost of this resolver.
      */
-    utils::rational get_estimated_cost() const noexcept;
+    const cost_t &get_estimated_cost() const noexcept { return est_cost; }
 
     /**
      * @brief Gets the preconditions of this resolver.
      *
-     * @return const std::vector<std::reference_wrapper<flaw>>& the preconditions of this resolver.
+     * @return const small_vector<std::reference_wrapper<flaw>, 4>& the preconditions of this resolver.
      */
-    const std::vector<std::reference_wrapper<flaw>> &get_preconditions() const noexcept { return preconditions; }
+    const small_vector<std::reference_wrapper<flaw>, 4> &get_preconditions() const noexcept { return preconditions; }
 
     /**
      * Applies this resolver, introducing subgoals and/or constraints.
@@ -102,10 +107,14 @@ namespace ratio
     void new_causal_link(flaw &f);
 
   private:
-    flaw &f;                                                 // the flaw solved by this resolver..
-    const semitone::lit rho;                                 // the propositional literal indicating whether the resolver is active or not..
-    const utils::rational intrinsic_cost;                    // the intrinsic cost of the resolver..
-    std::vector<std::reference_wrapper<flaw>> preconditions; // the preconditions of this resolver..
+    cost_t compute_estimated_cost() const noexcept; // computes the estimated cost of this resolver from the costs of its preconditions..
+
+  private:
+    flaw &f;                                                     // the flaw solved by this resolver..
+    const semitone::lit rho;                                     // the propositional literal indicating whether the resolver is active or not..
+    const utils::rational intrinsic_cost;                        // the intrinsic cost of the resolver..
+    cost_t est_cost;                                             // the current estimated cost of the resolver..
+    small_vector<std::reference_wrapper<flaw>, 4> preconditions; // the preconditions of this resolver..
   };
 
   using resolver_ptr = utils::u_ptr<resolver>;
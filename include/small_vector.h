@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ratio
+{
+  /**
+   * @brief A vector which stores up to `N` elements inline, spilling to the heap only when it grows beyond them.
+   *
+   * Flaws and resolvers keep several short lists (causes, resolvers, supports and preconditions) which, most of the times, contain just a few elements. Storing them inline avoids one heap allocation per list and keeps the elements next to the owning object, reducing cache misses while visiting the causal graph.
+   *
+   * @tparam T the type of the elements, which must be trivially copyable.
+   * @tparam N the number of elements stored inline.
+   */
+  template <typename T, size_t N>
+  class small_vector
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "small_vector elements must be trivially copyable");
+    static_assert(N > 0, "small_vector must have some inline storage");
+
+  public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    small_vector() noexcept = default;
+    small_vector(const std::vector<T> &v) { assign(v.data(), v.size()); }
+    small_vector(const small_vector &other) { assign(other.data(), other.size()); }
+    small_vector(small_vector &&other) noexcept
+    {
+      if (other.heap)
+      { // we steal the heap storage of the other vector..
+        heap = other.heap;
+        n = other.n;
+        cap = other.cap;
+        other.heap = nullptr;
+        other.n = 0;
+        other.cap = N;
+      }
+      else
+        assign(other.data(), other.size());
+    }
+    ~small_vector() { std::free(heap); }
+
+    small_vector &operator=(const small_vector &other)
+    {
+      if (this != &other)
+      {
+        n = 0;
+        assign(other.data(), other.size());
+      }
+      return *this;
+    }
+    small_vector &operator=(small_vector &&other) noexcept
+    {
+      if (this != &other)
+      {
+        if (other.heap)
+        { // we release our heap storage and steal the one of the other vector..
+          std::free(heap);
+          heap = other.heap;
+          n = other.n;
+          cap = other.cap;
+          other.heap = nullptr;
+          other.n = 0;
+          other.cap = N;
+        }
+        else
+        { // the elements of the other vector fit in our (inline or heap) storage..
+          std::memcpy(static_cast<void *>(data()), static_cast<const void *>(other.data()), other.n * sizeof(T));
+          n = other.n;
+          other.n = 0;
+        }
+      }
+      return *this;
+    }
+
+    T *data() noexcept { return heap ? heap : reinterpret_cast<T *>(buffer); }
+    const T *data() const noexcept { return heap ? heap : reinterpret_cast<const T *>(buffer); }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + n; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + n; }
+    const_iterator cbegin() const noexcept { return data(); }
+    const_iterator cend() const noexcept { return data() + n; }
+
+    size_t size() const noexcept { return n; }
+    size_t capacity() const noexcept { return cap; }
+    bool empty() const noexcept { return n == 0; }
+
+    T &operator[](const size_t &i) noexcept { return data()[i]; }
+    const T &operator[](const size_t &i) const noexcept { return data()[i]; }
+    T &front() noexcept { return data()[0]; }
+    const T &front() const noexcept { return data()[0]; }
+    T &back() noexcept { return data()[n - 1]; }
+    const T &back() const noexcept { return data()[n - 1]; }
+
+    void reserve(const size_t &new_cap)
+    {
+      if (new_cap <= cap)
+        return;
+      T *new_heap = static_cast<T *>(std::malloc(new_cap * sizeof(T)));
+      if (!new_heap)
+        throw std::bad_alloc();
+      std::memcpy(static_cast<void *>(new_heap), static_cast<const void *>(data()), n * sizeof(T));
+      std::free(heap);
+      heap = new_heap;
+      cap = new_cap;
+    }
+
+    void push_back(const T &val)
+    {
+      if (n == cap)
+      { // `val` might live in this vector, hence we copy it before growing..
+        const T tmp = val;
+        reserve(cap * 2);
+        new (data() + n++) T(tmp);
+      }
+      else
+        new (data() + n++) T(val);
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+      push_back(T(std::forward<Args>(args)...));
+      return back();
+    }
+
+    void pop_back() noexcept { --n; }
+    void clear() noexcept { n = 0; }
+
+  private:
+    void assign(const T *src, const size_t &count)
+    {
+      reserve(count);
+      std::memcpy(static_cast<void *>(data()), static_cast<const void *>(src), count * sizeof(T));
+      n = count;
+    }
+
+  private:
+    alignas(T) unsigned char buffer[N * sizeof(T)]; // the inline storage..
+    T *heap = nullptr;                               // the heap storage, used once the inline storage is exhausted..
+    size_t n = 0;                                    // the number of elements..
+    size_t cap = N;                                  // the current capacity..
+  };
+} // namespace ratio
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "type.h"
+#include "item.h"
 #include "sat_value_listener.h"
 #include "lra_value_listener.h"
 #include "rdl_value_listener.h"
@@ -10,6 +11,7 @@ namespace ratio
 {
   class solver;
   class atom;
+  class enum_item;
   class flaw;
   using flaw_ptr = utils::u_ptr<flaw>;
   class resolver;
@@ -51,6 +53,22 @@ namespace ratio
     solver &slv;
   };
 
+  /**
+   * @brief The fields of an atom which are frequently accessed by the smart types, resolved once when the atom is notified to the smart type.
+   *
+   */
+  struct atom_record
+  {
+    atom_record(atom &atm, const riddle::expr &start, const riddle::expr &end, const riddle::expr &tau, const riddle::expr &amount = {});
+
+    atom *atm;           // the atom..
+    riddle::expr start;  // the starting time point of the atom..
+    riddle::expr end;    // the ending time point of the atom..
+    riddle::expr tau;    // the `tau` parameter of the atom..
+    enum_item *tau_enum; // the `tau` parameter of the atom, if it is an enum variable (nullptr otherwise)..
+    riddle::expr amount; // the resource amount of the atom, if any..
+  };
+
   class atom_listener : public semitone::lra_value_listener, public semitone::rdl_value_listener, public semitone::ov_value_listener
   {
   public:
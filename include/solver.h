@@ -9,6 +9,11 @@
 #include "idl_theory.h"
 #include "rdl_theory.h"
 #include "graph.h"
+#include "unification_index.h"
+#include "memory_pool.h"
+#ifdef TOPOLOGICAL_ORDERING
+#include "topological_order.h"
+#endif
 
 #define RATIO_AT "at"
 #define RATIO_START "start"
@@ -41,14 +46,43 @@ namespace ratio
   class solver_listener;
 #endif
 
+  /**
+   * @brief The kinds of the items handled by the solver.
+   *
+   */
+  enum item_kind : uint8_t
+  {
+    bool_kind,   // boolean items..
+    arith_kind,  // integer and real items..
+    time_kind,   // time point items..
+    string_kind, // string items..
+    enum_kind,   // enum (i.e., object variable) items..
+    complex_kind // complex items, atoms and any other non-primitive item..
+  };
+
+  /**
+   * @brief A base class for the primitive (i.e., boolean, arithmetic and string) items, tagged with their kind.
+   *
+   */
+  class primitive_item : public riddle::item
+  {
+  public:
+    primitive_item(riddle::type &t, const item_kind &k) : item(t), kind(k) {}
+
+    item_kind get_kind() const noexcept { return kind; }
+
+  private:
+    const item_kind kind;
+  };
+
   /**
    * @brief A class for representing boolean items.
    *
    */
-  class bool_item : public riddle::item
+  class bool_item : public primitive_item
   {
   public:
-    bool_item(riddle::type &t, const semitone::lit &l) : item(t), l(l) {}
+    bool_item(riddle::type &t, const semitone::lit &l) : primitive_item(t, bool_kind), l(l) {}
 
     semitone::lit get_lit() const { return l; }
 
@@ -60,25 +94,30 @@ namespace ratio
    * @brief A class for representing arithmetic items. Arithmetic items can be either integers, reals, or time points.
    *
    */
-  class arith_item : public riddle::item
+  class arith_item : public primitive_item
   {
+    friend class solver;
+
   public:
-    arith_item(riddle::type &t, const semitone::lin &l) : item(t), l(l) {}
+    arith_item(riddle::type &t, const semitone::lin &l) : primitive_item(t, t == t.get_core().get_time_type() ? time_kind : arith_kind), l(l) {}
+    arith_item(riddle::type &t, semitone::lin &&l) : primitive_item(t, t == t.get_core().get_time_type() ? time_kind : arith_kind), l(std::move(l)) {}
+    ~arith_item();
 
-    semitone::lin get_lin() const { return l; }
+    const semitone::lin &get_lin() const noexcept { return l; }
 
   private:
     const semitone::lin l;
+    bool interned = false; // whether this item is listed in the solver's table of linear expressions..
   };
 
   /**
    * @brief A class for representing string items.
    *
    */
-  class string_item : public riddle::item, public utils::enum_val
+  class string_item : public primitive_item, public utils::enum_val
   {
   public:
-    string_item(riddle::type &t, const std::string &s = "") : item(t), s(s) {}
+    string_item(riddle::type &t, const std::string &s = "") : primitive_item(t, string_kind), s(s) {}
 
     const std::string &get_string() const { return s; }
 
@@ -101,12 +140,28 @@ namespace ratio
     const semitone::var ev;
   };
 
+  /**
+   * @brief A class for representing complex items (i.e., instances of complex types).
+   *
+   */
+  class complex_item : public riddle::complex_item
+  {
+    friend class solver;
+
+  public:
+    complex_item(riddle::complex_type &tp) : riddle::complex_item(tp) {}
+
+  private:
+    std::vector<riddle::item *> slots; // the values of the non-synthetic fields, following the field layout of the type (resolved upon the first comparison)..
+  };
+
   /**
    * @brief A class for representing atoms.
    *
    */
   class atom : public riddle::atom
   {
+    friend class solver;
     friend class atom_flaw;
 
   public:
@@ -119,16 +174,19 @@ namespace ratio
     friend std::string to_string(const atom &a) noexcept;
 
   private:
-    semitone::lit sigma; // the literal that represents this atom..
-    atom_flaw *reason;   // the atom_flaw that caused this atom to be created..
+    semitone::lit sigma;               // the literal that represents this atom..
+    atom_flaw *reason;                 // the atom_flaw that caused this atom to be created..
+    std::vector<riddle::item *> slots; // the values of the non-synthetic fields, following the field layout of the predicate (resolved upon the first comparison)..
   };
 
-  class solver : public riddle::core, public semitone::theory
+  class solver : private memory_pool::user, public riddle::core, public semitone::theory
   {
     friend class flaw;
     friend class resolver;
     friend class graph;
     friend class smart_type;
+    friend class atom_flaw;
+    friend class arith_item;
 #ifdef BUILD_LISTENERS
     friend class solver_listener;
 #endif
@@ -136,6 +194,7 @@ namespace ratio
   public:
     ORATIOSOLVER_EXPORT solver(const bool &i = true);
     ORATIOSOLVER_EXPORT solver(graph_ptr g, const bool &i = true);
+    ORATIOSOLVER_EXPORT ~solver();
 
     /**
      * @brief Initialize the solver.
@@ -182,6 +241,14 @@ namespace ratio
      * @return const semitone::idl_theory& The integer difference logic theory.
      */
     const semitone::idl_theory &get_idl_theory() const { return idl_th; }
+#ifdef TOPOLOGICAL_ORDERING
+    /**
+     * @brief Get the topological order of the flaws, used for detecting causal cycles in place of the integer difference logic theory.
+     *
+     * @return const topological_order& The topological order of the flaws.
+     */
+    const topological_order &get_topological_order() const { return t_ord; }
+#endif
     /**
      * @brief Get the real difference logic theory.
      *
@@ -234,7 +301,35 @@ namespace ratio
      * @return true If the two expressions can be made equal.
      * @return false If the two expressions can not be made equal.
      */
-    bool matches(const riddle::expr &lhs, const riddle::expr &rhs) const noexcept;
+    ORATIOSOLVER_EXPORT bool matches(const riddle::expr &lhs, const riddle::expr &rhs) const;
+
+    /**
+     * @brief Creates, or retrieves if already created, the literal representing the `lhs < rhs` constraint.
+     *
+     * @param lhs The left-hand side arithmetic expression.
+     * @param rhs The right-hand side arithmetic expression.
+     * @param rdl Whether the constraint is posted to the real difference logic theory rather than to the linear real arithmetic theory.
+     * @return semitone::lit The literal representing the constraint.
+     */
+    semitone::lit new_lt(const riddle::expr &lhs, const riddle::expr &rhs, const bool &rdl) { return new_constraint('<', rdl, lhs, rhs); }
+    /**
+     * @brief Creates, or retrieves if already created, the literal representing the `lhs <= rhs` constraint.
+     *
+     * @param lhs The left-hand side arithmetic expression.
+     * @param rhs The right-hand side arithmetic expression.
+     * @param rdl Whether the constraint is posted to the real difference logic theory rather than to the linear real arithmetic theory.
+     * @return semitone::lit The literal representing the constraint.
+     */
+    semitone::lit new_leq(const riddle::expr &lhs, const riddle::expr &rhs, const bool &rdl) { return new_constraint('l', rdl, lhs, rhs); }
+    /**
+     * @brief Creates, or retrieves if already created, the literal representing the `lhs == rhs` constraint.
+     *
+     * @param lhs The left-hand side arithmetic expression.
+     * @param rhs The right-hand side arithmetic expression.
+     * @param rdl Whether the constraint is posted to the real difference logic theory rather than to the linear real arithmetic theory.
+     * @return semitone::lit The literal representing the constraint.
+     */
+    semitone::lit new_eq(const riddle::expr &lhs, const riddle::expr &rhs, const bool &rdl) { return new_constraint('=', rdl, lhs, rhs); }
 
     ORATIOSOLVER_EXPORT riddle::expr conj(const std::vector<riddle::expr> &xprs) override;
     ORATIOSOLVER_EXPORT riddle::expr disj(const std::vector<riddle::expr> &xprs) override;
@@ -261,14 +356,57 @@ namespace ratio
     ORATIOSOLVER_EXPORT std::pair<utils::inf_rational, utils::inf_rational> time_bounds(const riddle::expr &xpr) const override;
 
     ORATIOSOLVER_EXPORT bool is_enum(const riddle::expr &xpr) const override;
+    /**
+     * @brief Gets the kind of the given item.
+     *
+     * Primitive items carry their kind, which is read without resorting to RTTI. Only items of complex types, which derive from the RiDDLe item classes, need a type check for telling enums apart from complex items and atoms.
+     *
+     * @param itm the item whose kind is requested.
+     * @return item_kind the kind of the given item.
+     */
+    item_kind get_kind(const riddle::item &itm) const noexcept;
+    /**
+     * @brief Gets the given item as a value of an enum, dispatching on its kind.
+     *
+     * @param itm the item to be used as a value of an enum.
+     * @return utils::enum_val* the item as a value of an enum, or nullptr if the item (e.g., a boolean, an arithmetic or an enum item) cannot be a value of an enum.
+     */
+    utils::enum_val *get_enum_val(riddle::item &itm) const noexcept;
     ORATIOSOLVER_EXPORT std::vector<riddle::expr> domain(const riddle::expr &xpr) const override;
     void prune(const riddle::expr &xpr, const riddle::expr &val) override;
 
+    /**
+     * @brief Sets the default maximum number of unification resolvers of each atom. The exceeding unification targets are considered, if needed, through an overflow resolver.
+     *
+     * @param cap the maximum number of unification resolvers of each atom (0 means unbounded).
+     */
+    void set_unification_cap(const size_t &cap) noexcept { unif_cap = cap; }
+    /**
+     * @brief Sets the maximum number of unification resolvers of the atoms of the given predicate. The exceeding unification targets are considered, if needed, through an overflow resolver.
+     *
+     * @param pred the predicate whose atoms are capped.
+     * @param cap the maximum number of unification resolvers of the atoms of the given predicate (0 means unbounded).
+     */
+    void set_unification_cap(const riddle::predicate &pred, const size_t &cap) { unif_caps[&pred] = cap; }
+    /**
+     * @brief Gets the maximum number of unification resolvers of the atoms of the given predicate.
+     *
+     * @param pred the predicate whose cap is requested.
+     * @return size_t the maximum number of unification resolvers of the atoms of the given predicate (0 means unbounded).
+     */
+    size_t get_unification_cap(const riddle::predicate &pred) const noexcept
+    {
+      if (const auto cap_it = unif_caps.find(&pred); cap_it != unif_caps.cend())
+        return cap_it->second;
+      return unif_cap;
+    }
+
     /**
      * @brief Solves the current problem returning whether a solution was found.
      *
      * @return true If a solution was found.
      * @return false If no solution was found.
+     * @throws budget_exceeded_exception If the causal graph exceeds its budget before providing an estimated solution.
      */
     ORATIOSOLVER_EXPORT bool solve();
     /**
@@ -289,9 +427,61 @@ namespace ratio
     void new_resolver(resolver_ptr r);                     // notifies the solver that a new resolver `r` has been created..
     void new_causal_link(flaw &f, resolver &r);            // notifies the solver that a new causal link between `f` and `r` has been created..
 
-    void expand_flaw(flaw &f);                    // expands the given flaw, computing its resolvers and applying them..
-    void apply_resolver(resolver &r);             // applies the given resolver..
-    void set_cost(flaw &f, utils::rational cost); // sets the cost of the given flaw to the given value, storing the old cost in the current layer of the trail..
+    void expand_flaw(flaw &f);               // expands the given flaw, computing its resolvers and applying them..
+    void apply_resolver(resolver &r);        // applies the given resolver..
+    void set_cost(flaw &f, cost_t cost);     // sets the cost of the given flaw to the given value, storing the old cost in the current layer of the trail..
+    void update_cost(resolver &r);           // recomputes the cost of the given resolver, storing the old cost in the current layer of the trail and updating the cheapest resolver of its flaw..
+    void set_cheapest(flaw &f, resolver &r); // sets the cheapest resolver of the given flaw, storing the old one in the current layer of the trail..
+
+    /**
+     * @brief The layout of the fields of a type, shared by all of its instances.
+     *
+     */
+    struct field_layout
+    {
+      std::vector<std::string> names; // the names of the non-synthetic fields, followed by the inherited ones..
+      bool atoms = false;             // whether the instances of the type are atoms..
+    };
+
+    /**
+     * @brief Gets the layout of the non-synthetic fields of the given type, including the inherited ones.
+     *
+     * @param tp the type whose fields are requested.
+     * @return const field_layout& the layout of the fields of the given type.
+     */
+    const field_layout &get_field_layout(const riddle::type &tp) const;
+    /**
+     * @brief Gets the values of the fields of the given complex item, in the order given by the layout of its type.
+     *
+     * The values are looked up by name only once, upon the first request, and stored within the item.
+     *
+     * @param itm the complex item (or atom) whose field values are requested.
+     * @param layout the layout of the type of the item.
+     * @return const std::vector<riddle::item *>& the values of the fields of the item.
+     */
+    const std::vector<riddle::item *> &get_slots(riddle::item &itm, const field_layout &layout) const;
+    /**
+     * @brief Creates, or retrieves from the constraint cache, the literal representing the `lhs op rhs` arithmetic constraint.
+     *
+     * @param op the (normalized) operator of the constraint, either '<', 'l' (for `<=`) or '='.
+     * @param rdl whether the constraint is posted to the real difference logic theory.
+     * @param lhs the left-hand side arithmetic expression.
+     * @param rhs the right-hand side arithmetic expression.
+     * @return semitone::lit the literal representing the constraint.
+     */
+    semitone::lit new_constraint(const char &op, const bool &rdl, const riddle::expr &lhs, const riddle::expr &rhs);
+    /**
+     * @brief Creates, or retrieves if already created, the arithmetic item of the given type representing the given linear expression.
+     *
+     * @param tp the type of the item.
+     * @param l the linear expression.
+     * @return riddle::expr the arithmetic item representing the linear expression.
+     */
+    riddle::expr new_lin(riddle::type &tp, semitone::lin &&l);
+
+#ifdef LAZY_GRAPH
+    bool expand_lazily(flaw &f); // expands, at root-level, the causal subgraph supporting the given flaw, restoring the current decisions afterwards (returns false if there is nothing to expand)..
+#endif
 
     void solve_inconsistencies();                                          // checks whether the types have any inconsistency and, in case, solve them..
     std::vector<std::vector<std::pair<semitone::lit, double>>> get_incs(); // collects all the current inconsistencies..
@@ -306,9 +496,9 @@ namespace ratio
 
     void restore_ni() noexcept { ni = tmp_ni; }
 
-    const std::unordered_map<semitone::var, std::vector<flaw_ptr>> &get_flaws() const noexcept { return phis; }
+    const std::vector<std::vector<flaw_ptr>> &get_flaws() const noexcept { return phis; }
     const std::unordered_set<flaw *> &get_active_flaws() const noexcept { return active_flaws; }
-    const std::unordered_map<semitone::var, std::vector<resolver_ptr>> &get_resolvers() const noexcept { return rhos; }
+    const std::vector<std::vector<resolver_ptr>> &get_resolvers() const noexcept { return rhos; }
 
     inline const std::vector<std::reference_wrapper<resolver>> get_cause()
     {
@@ -333,9 +523,21 @@ namespace ratio
     bool is_interval(const atom &atm) const noexcept { return int_pred->is_assignable_from(atm.get_type()); }
 
   private:
-    riddle::predicate *imp_pred = nullptr; // the `Impulse` predicate..
-    riddle::predicate *int_pred = nullptr; // the `Interval` predicate..
-    std::vector<smart_type *> smart_types; // the smart-types..
+    riddle::predicate *imp_pred = nullptr;                                        // the `Impulse` predicate..
+    riddle::predicate *int_pred = nullptr;                                        // the `Interval` predicate..
+    std::vector<smart_type *> smart_types;                                        // the smart-types..
+    unification_index unif_idx;                                                   // the index of the unification candidates..
+    size_t unif_cap;                                                              // the default maximum number of unification resolvers of each atom (0 means unbounded)..
+    std::unordered_map<const riddle::predicate *, size_t> unif_caps;              // the maximum number of unification resolvers of the atoms of specific predicates..
+    mutable std::unordered_map<const riddle::type *, field_layout> field_layouts; // the (lazily computed) field layouts of the complex types..
+
+    struct lin_less
+    {
+      bool operator()(const semitone::lin &l0, const semitone::lin &l1) const noexcept;
+      bool operator()(const std::pair<const riddle::type *, const semitone::lin *> &l0, const std::pair<const riddle::type *, const semitone::lin *> &l1) const noexcept;
+    };
+    std::map<std::pair<const riddle::type *, const semitone::lin *>, arith_item *, lin_less> lins; // the linear expressions built so far, indexed by their type and value (items remove themselves when destroyed)..
+    std::map<std::pair<char, bool>, std::map<semitone::lin, semitone::lit, lin_less>> constraints; // the arithmetic constraints built so far, indexed by their (normalized) operator and theory and by the (normalized) difference of their sides..
 
     semitone::lit tmp_ni;                  // the temporary controlling literal, used for restoring the controlling literal..
     semitone::lit ni = semitone::TRUE_lit; // the current controlling literal..
@@ -344,22 +546,40 @@ namespace ratio
     semitone::ov_theory ov_th;   // the object-variable theory..
     semitone::idl_theory idl_th; // the integer difference logic theory..
     semitone::rdl_theory rdl_th; // the real difference logic theory..
+#ifdef TOPOLOGICAL_ORDERING
+    topological_order t_ord; // the topological order of the flaws, w.r.t. the causal links of the active resolvers..
+#endif
 
     graph_ptr gr;                            // the causal graph..
     resolver *res = nullptr;                 // the current resolver (i.e. the cause for the new flaws)..
     std::unordered_set<flaw *> active_flaws; // the currently active flaws..
     std::vector<flaw_ptr> pending_flaws;     // pending flaws, waiting for root-level to be initialized..
 
-    std::unordered_map<semitone::var, std::vector<flaw_ptr>> phis;     // the phi variables (propositional variable to flaws) of the flaws..
-    std::unordered_map<semitone::var, std::vector<resolver_ptr>> rhos; // the rho variables (propositional variable to resolver) of the resolvers..
+    std::vector<std::vector<flaw_ptr>> phis;     // the phi variables (indexed by propositional variable) of the flaws..
+    std::vector<std::vector<resolver_ptr>> rhos; // the rho variables (indexed by propositional variable) of the resolvers..
 
     struct layer
     {
-      std::unordered_map<flaw *, utils::rational> old_f_costs; // the old estimated flaws` costs..
-      std::unordered_set<flaw *> new_flaws;                    // the just activated flaws..
-      std::unordered_set<flaw *> solved_flaws;                 // the just solved flaws..
+      size_t old_f_costs;   // the number of stored flaws` costs when the layer has been created..
+      size_t old_r_costs;   // the number of stored resolvers` costs when the layer has been created..
+      size_t old_cheapests; // the number of stored flaws` cheapest resolvers when the layer has been created..
+      size_t new_flaws;     // the number of stored activated flaws when the layer has been created..
+      size_t solved_flaws;  // the number of stored solved flaws when the layer has been created..
+#ifdef TOPOLOGICAL_ORDERING
+      size_t causal_edges;  // the number of stored causal edges when the layer has been created..
+#endif
     };
-    std::vector<layer> trail; // the list of taken decisions, with the associated changes made, in chronological order..
+    std::vector<layer> trail;                                 // the list of taken decisions, with the watermarks of the associated changes made, in chronological order..
+    std::vector<std::pair<flaw *, cost_t>> old_f_costs;       // the old estimated flaws` costs, in chronological order..
+    std::vector<std::pair<resolver *, cost_t>> old_r_costs;   // the old estimated resolvers` costs, in chronological order..
+    std::vector<std::pair<flaw *, resolver *>> old_cheapests; // the old cheapest resolvers of the flaws, in chronological order..
+    std::vector<flaw *> new_flaws;                            // the flaws activated after the root level, in chronological order..
+    std::vector<flaw *> solved_flaws;                         // the flaws solved after the root level, in chronological order..
+#ifdef TOPOLOGICAL_ORDERING
+    std::vector<std::pair<flaw *, resolver *>> causal_edges; // the causal edges (i.e., the preconditions of the activated resolvers) added to the topological order after the root level, in chronological order..
+
+    bool add_causal_edge(flaw &f, resolver &r); // adds to the topological order the edge from the given precondition to the effect of the given resolver, returning false, and setting the conflict, in case of a causal cycle..
+#endif
 
 #ifdef BUILD_LISTENERS
   private:
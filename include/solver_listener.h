@@ -48,7 +48,9 @@ namespace ratio
       flaw_listener(solver_listener &l, const flaw &f) : sat_value_listener(l.slv.get_sat_core_ptr()), idl_value_listener(l.slv.get_idl_theory()), listener(l), f(f)
       {
         listen_sat(variable(f.get_phi()));
+#ifndef TOPOLOGICAL_ORDERING // positions are not represented by integer difference logic variables, hence there is nothing to listen for..
         listen_idl(f.get_position());
+#endif
       }
       flaw_listener(const flaw_listener &orig) = delete;
       virtual ~flaw_listener() {}
@@ -94,7 +96,11 @@ namespace ratio
   }
   inline json::json flaw_state_changed_message(const flaw &f) noexcept { return {{"type", "flaw_state_changed"}, {"solver_id", get_id(f.get_solver())}, {"id", get_id(f)}, {"state", f.get_solver().get_sat_core().value(f.get_phi())}}; }
   inline json::json flaw_cost_changed_message(const flaw &f) noexcept { return {{"type", "flaw_cost_changed"}, {"solver_id", get_id(f.get_solver())}, {"id", get_id(f)}, {"cost", to_json(f.get_estimated_cost())}}; }
+#ifdef TOPOLOGICAL_ORDERING
+  inline json::json flaw_position_changed_message(const flaw &f) noexcept { return {{"type", "flaw_position_changed"}, {"solver_id", get_id(f.get_solver())}, {"id", get_id(f)}, {"pos", {{"lb", f.get_solver().get_topological_order().position(f.get_position())}, {"ub", f.get_solver().get_topological_order().position(f.get_position())}}}}; }
+#else
   inline json::json flaw_position_changed_message(const flaw &f) noexcept { return {{"type", "flaw_position_changed"}, {"solver_id", get_id(f.get_solver())}, {"id", get_id(f)}, {"pos", to_json(f.get_solver().get_idl_theory().bounds(f.get_position()))}}; }
+#endif
   inline json::json current_flaw_message(const flaw &f) noexcept { return {{"type", "current_flaw"}, {"solver_id", get_id(f.get_solver())}, {"id", get_id(f)}}; }
 
   inline json::json resolver_created_message(const resolver &r) noexcept
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "oratiosolver_export.h"
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+namespace ratio
+{
+  class resolver;
+
+  /**
+   * @brief An incrementally maintained topological order of the nodes of a directed acyclic graph, based on the Pearce–Kelly dynamic topological sort algorithm.
+   *
+   * Inserting an edge which agrees with the current order costs nothing more than storing it, while inserting an edge which disagrees with it only reorders the nodes comprised between its endpoints. Removing edges never invalidates the order. Each edge is labelled with the resolver it comes from (if any), so that the resolvers responsible for a cycle can be retrieved.
+   */
+  class topological_order
+  {
+  public:
+    /**
+     * @brief Creates a new node, placing it at the end of the order.
+     *
+     * @return size_t the new node.
+     */
+    ORATIOSOLVER_EXPORT size_t new_node();
+
+    /**
+     * @brief Adds the edge from the `from` node to the `to` node, labelled with the given resolver, reordering the nodes if required.
+     *
+     * If the edge would close a cycle, the edge is not added and the labels of the edges of the path from the `to` node to the `from` node are collected into `cycle`.
+     *
+     * @param from the source of the edge.
+     * @param to the target of the edge.
+     * @param r the label of the edge (nullptr for unlabelled edges).
+     * @param cycle the labels of the path closing the cycle, if any.
+     * @return true if the edge has been added.
+     * @return false if the edge would close a cycle.
+     */
+    ORATIOSOLVER_EXPORT bool add_edge(const size_t &from, const size_t &to, resolver *r, std::vector<resolver *> &cycle);
+    /**
+     * @brief Removes the edge from the `from` node to the `to` node labelled with the given resolver.
+     *
+     * @param from the source of the edge.
+     * @param to the target of the edge.
+     * @param r the label of the edge.
+     */
+    ORATIOSOLVER_EXPORT void remove_edge(const size_t &from, const size_t &to, const resolver *r);
+
+    /**
+     * @brief Checks whether the `to` node is reachable from the `from` node.
+     *
+     * @param from the source node.
+     * @param to the target node.
+     * @return true if there is a path from the `from` node to the `to` node.
+     */
+    ORATIOSOLVER_EXPORT bool reaches(const size_t &from, const size_t &to) const;
+
+    /**
+     * @brief Gets the position of the given node within the current order.
+     *
+     * @param n the node.
+     * @return size_t the position of the node.
+     */
+    size_t position(const size_t &n) const noexcept { return ord[n]; }
+
+  private:
+    std::vector<std::vector<std::pair<size_t, resolver *>>> out_edges; // the outgoing edges of the nodes, with their labels..
+    std::vector<std::vector<std::pair<size_t, resolver *>>> in_edges;  // the incoming edges of the nodes, with their labels..
+    std::vector<size_t> ord;                                           // the positions of the nodes within the order..
+    std::vector<size_t> nodes;                                         // the nodes, in order..
+  };
+} // namespace ratio
@@ -101,7 +101,7 @@ namespace ratio
 
   private:
     std::set<const riddle::item *> to_check;     // the reusable-resource instances whose atoms have changed..
-    std::vector<atom *> atoms;                   // we store, for each atom, its atom listener..
+    std::vector<atom_record> atoms;              // the atoms of the reusable-resource, with their frequently accessed fields..
     std::vector<rr_atom_listener_ptr> listeners; // we store, for each atom, its atom listener..
 
     std::map<std::set<atom *>, rr_flaw *> rr_flaws;                 // the reusable-resource flaws found so far..
@@ -99,7 +99,7 @@ namespace ratio
 
   private:
     std::set<const riddle::item *> to_check;     // the state-variable instances whose atoms have changed..
-    std::vector<atom *> atoms;                   // we store, for each atom, its atom listener..
+    std::vector<atom_record> atoms;              // the atoms of the state-variable, with their frequently accessed fields..
     std::vector<sv_atom_listener_ptr> listeners; // we store, for each atom, its atom listener..
 
     std::map<std::set<atom *>, sv_flaw *> sv_flaws;                 // the state-variable flaws found so far..
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "oratiosolver_export.h"
+#include "item.h"
+#include "rational.h"
+#include <unordered_map>
+
+namespace ratio
+{
+  class solver;
+  class atom;
+
+  /**
+   * @brief An index of the atoms of the predicates, used for quickly retrieving the candidate targets of a unification.
+   *
+   * The atoms are bucketed, for each of the non-synthetic enumerable arguments of their predicate, by the values they can assume. These are exactly the enumerable fields compared by `solver::matches`, hence synthetic fields (e.g., `tau`, whenever it is synthetic) are neither compared nor indexed. The bounds of the atoms' starting (or `at`) time point are also stored so that atoms which cannot overlap in time are filtered out before calling the more expensive `solver::matches` and `solver::eq` methods.
+   * The index is built lazily, upon the first request for the candidates of an atom of a given predicate, and is incrementally updated as new atoms are created. Since values are recorded at root level, where domains and bounds can only shrink, the returned candidates are always a superset of the atoms that can match.
+   */
+  class unification_index
+  {
+  public:
+    ORATIOSOLVER_EXPORT unification_index(solver &s);
+
+    /**
+     * @brief Gets the atoms which can be unified with the given atom.
+     *
+     * The returned atoms are a superset of the atoms that match the given atom, sorted by their creation order.
+     *
+     * @param atm The atom to get the candidate targets of.
+     * @return std::vector<atom *> The candidate targets.
+     */
+    ORATIOSOLVER_EXPORT std::vector<atom *> get_candidates(atom &atm);
+
+    /**
+     * @brief Sorts the given unification targets from the most to the least promising for the given atom.
+     *
+     * Targets are ranked by the distance between the lower bounds of their temporal argument and the one of the given atom, ties being broken by their order.
+     *
+     * @param atm The atom to unify.
+     * @param targets The unification targets to sort.
+     */
+    void rank(atom &atm, std::vector<atom *> &targets);
+
+  private:
+    struct predicate_index
+    {
+      size_t n_instances = 0;                                                                // the number of instances of the predicate that have been already indexed..
+      std::vector<std::string> keys;                                                         // the names of the indexed arguments..
+      std::string time_key;                                                                  // the name of the (`start` or `at`) temporal argument, if any..
+      std::vector<atom *> atoms;                                                             // the indexed atoms, in creation order..
+      std::vector<std::pair<utils::inf_rational, utils::inf_rational>> bounds;               // the bounds of the temporal argument of the indexed atoms..
+      std::vector<std::unordered_map<const utils::enum_val *, std::vector<size_t>>> buckets; // for each indexed argument, the atoms (by position) that can assume a given value..
+      std::vector<std::vector<size_t>> wildcards;                                            // for each indexed argument, the atoms (by position) whose values have not been recorded at root level..
+    };
+
+    predicate_index &get_index(const riddle::predicate &pred);                                              // returns the (up-to-date) index of the given predicate..
+    void add_atom(predicate_index &p_idx, atom &atm);                                                       // adds the given atom to the given predicate index..
+    std::vector<const utils::enum_val *> get_values(const riddle::expr &xpr) const noexcept;                // returns the values the given expression can assume..
+    std::pair<utils::inf_rational, utils::inf_rational> get_bounds(const riddle::expr &xpr) const noexcept; // returns the bounds of the given temporal expression..
+
+  private:
+    solver &slv;                                                            // the solver this index belongs to..
+    std::unordered_map<const riddle::predicate *, predicate_index> indexes; // the indexes of the predicates..
+  };
+} // namespace ratio
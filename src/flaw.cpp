@@ -6,16 +6,22 @@
 
 namespace ratio
 {
-    flaw::flaw(solver &s, std::vector<std::reference_wrapper<resolver>> causes, const bool &exclusive) : s(s), causes(causes), exclusive(exclusive), position(s.idl_th.new_var()) {}
+#ifdef TOPOLOGICAL_ORDERING
+    flaw::flaw(solver &s, std::vector<std::reference_wrapper<resolver>> causes, const bool &exclusive) : s(s), exclusive(exclusive), position(s.t_ord.new_node()), causes(causes) {}
+#else
+    flaw::flaw(solver &s, std::vector<std::reference_wrapper<resolver>> causes, const bool &exclusive) : s(s), exclusive(exclusive), position(s.idl_th.new_var()), causes(causes) {}
+#endif
 
     void flaw::init() noexcept
     {
         assert(!expanded);
         assert(s.sat->root_level());
 
+#ifndef TOPOLOGICAL_ORDERING
         // this flaw's position must be greater than 0..
         [[maybe_unused]] bool add_distance = s.get_sat_core().new_clause({s.idl_th.new_distance(position, 0, 0)});
         assert(add_distance);
+#endif
 
         // we consider the causes of this flaw..
         std::vector<semitone::lit> cs;
@@ -24,10 +30,17 @@ namespace ratio
         {
             c.get().preconditions.push_back(*this); // this flaw is a precondition of its `c` cause..
             supports.push_back(c);                  // .. and it also supports the `c` cause..
+            s.update_cost(c);                       // .. whose cost now depends on this flaw..
             cs.push_back(c.get().get_rho());
             // we force this flaw to stay before the effects of its causes..
+#ifdef TOPOLOGICAL_ORDERING
+            std::vector<resolver *> cycle;
+            [[maybe_unused]] bool edge = s.t_ord.add_edge(position, c.get().f.position, nullptr, cycle);
+            assert(edge); // the flaw has no incoming edges, hence it cannot close a cycle..
+#else
             [[maybe_unused]] bool dist = s.get_sat_core().new_clause({s.idl_th.new_distance(c.get().f.position, position, -1)});
             assert(dist);
+#endif
         }
 
         // we initialize the phi variable as the conjunction of the causes' rho variables..
@@ -76,24 +89,17 @@ namespace ratio
         if (!s.get_sat_core().new_clause({!r->get_rho(), phi}))
             throw riddle::unsolvable_exception();
         resolvers.push_back(*r);
+        if (!cheapest || r->get_estimated_cost() < cheapest->get_estimated_cost())
+            s.set_cheapest(*this, *r);
         s.new_resolver(std::move(r)); // we notify the solver that a new resolver has been added..
     }
 
     resolver &flaw::get_cheapest_resolver() const noexcept
     {
         assert(!resolvers.empty());
-        resolver *cheapest = &resolvers[0].get();
-        utils::rational cheapest_cost = cheapest->get_estimated_cost();
-        for (size_t i = 1; i < resolvers.size(); ++i)
-        {
-            resolver &r = resolvers[i].get();
-            utils::rational cost = resolvers[i].get().get_estimated_cost();
-            if (cost < cheapest_cost)
-            {
-                cheapest = &r;
-                cheapest_cost = cost;
-            }
-        }
+        assert(cheapest);
+        assert(std::none_of(resolvers.cbegin(), resolvers.cend(), [this](const auto &r)
+                            { return r.get().get_estimated_cost() < cheapest->get_estimated_cost(); }));
         return *cheapest;
     }
 
@@ -117,7 +123,12 @@ namespace ratio
 
     json::json to_json(const flaw &f) noexcept
     {
-        json::json j_f{{"id", get_id(f)}, {"phi", to_string(f.get_phi())}, {"state", f.get_solver().get_sat_core().value(f.get_phi())}, {"cost", to_json(f.get_estimated_cost())}, {"pos", to_json(f.get_solver().get_idl_theory().bounds(f.get_position()))}, {"data", f.get_data()}};
+        json::json j_f{{"id", get_id(f)}, {"phi", to_string(f.get_phi())}, {"state", f.get_solver().get_sat_core().value(f.get_phi())}, {"cost", to_json(f.get_estimated_cost())}, {"data", f.get_data()}};
+#ifdef TOPOLOGICAL_ORDERING
+        j_f["pos"] = {{"lb", f.get_solver().get_topological_order().position(f.get_position())}, {"ub", f.get_solver().get_topological_order().position(f.get_position())}};
+#else
+        j_f["pos"] = to_json(f.get_solver().get_idl_theory().bounds(f.get_position()));
+#endif
         json::json causes(json::json_type::array);
         for (const auto &c : f.get_causes())
             causes.push_back(get_id(c.get()));
@@ -14,35 +14,9 @@ namespace ratio
         LOG("computing resolvers for " << to_string(c_atm) << "..");
         assert(get_solver().get_sat_core().value(c_atm.sigma) != utils::False);
         // we check if the atom can unify..
-        if (get_solver().get_sat_core().value(c_atm.sigma) == utils::Undefined)
-            for (auto &i : static_cast<riddle::predicate &>(c_atm.get_type()).get_instances())
-            { // we check for possible unifications (i.e. all the instances of the atom's type)..
-                if (i.operator->() == &c_atm)
-                    continue; // the current atom cannot unify with itself..
-
-                // this is the target (i.e. the atom we are trying to unify with)..
-                auto &t_atm = static_cast<atom &>(*i);
-
-                if (!t_atm.reason->is_expanded() ||                                                                   // we cannot unify with an atom that is not expanded..
-                    get_solver().get_idl_theory().distance(get_position(), t_atm.reason->get_position()).first > 0 || // we cannot unify with an atom that introduces a cycle..
-                    get_solver().get_sat_core().value(t_atm.sigma) == utils::False ||                                 // we cannot unify with an atom that is unified with another atom..
-                    get_solver().get_sat_core().value(t_atm.reason->get_phi()) == utils::False ||                     // we cannot unify with an atom that cannot be activated..
-                    !get_solver().matches(atm, i))                                                                    // we cannot unify with an atom that does not match the current atom..
-                    continue;
-
-                // the equality propositional literal..
-                auto eq_lit = static_cast<bool_item &>(*get_solver().eq(atm, i)).get_lit();
-
-                if (get_solver().get_sat_core().value(eq_lit) == utils::False)
-                    continue; // the two atoms cannot unify, hence, we skip this instance..
-
-                LOG("found possible unification with " << to_string(t_atm) << "..");
-
-                // we add the resolver..
-                auto u_res = new unify_atom(*this, i, eq_lit);
-                assert(get_solver().get_sat_core().value(u_res->get_rho()) != utils::False);
-                add_resolver(u_res);
-            }
+        if (get_solver().get_sat_core().value(c_atm.sigma) == utils::Undefined) // we check for possible unifications (i.e. the instances of the atom's type which are compatible with the atom)..
+            for (auto &u_res : compute_unifications(*this, get_solver().unif_idx.get_candidates(c_atm)))
+                add_resolver(std::move(u_res));
 
         if (c_atm.is_fact())
             if (get_resolvers().empty())
@@ -55,8 +29,86 @@ namespace ratio
             add_resolver(new activate_goal(*this));
     }
 
+    std::vector<resolver_ptr> atom_flaw::compute_unifications(flaw &f, std::vector<atom *> targets)
+    {
+        // this is the current atom..
+        auto &c_atm = static_cast<atom &>(*atm);
+
+        // checks whether unifying with an atom introduced by the given flaw would introduce a causal cycle..
+        const auto introduces_cycle = [this, &f](const flaw &t_f)
+        {
+#ifdef TOPOLOGICAL_ORDERING
+            return get_solver().get_topological_order().reaches(f.get_position(), t_f.get_position());
+#else
+            return get_solver().get_idl_theory().distance(f.get_position(), t_f.get_position()).first > 0;
+#endif
+        };
+
+        std::vector<atom *> c_targets;
+        for (const auto &t_atm_ptr : targets)
+        {
+            if (t_atm_ptr == &c_atm)
+                continue; // the current atom cannot unify with itself..
+
+            // this is the target (i.e. the atom we are trying to unify with)..
+            auto &t_atm = *t_atm_ptr;
+
+            if (!t_atm.reason->is_expanded() ||                                               // we cannot unify with an atom that is not expanded..
+                introduces_cycle(*t_atm.reason) ||                                            // we cannot unify with an atom that introduces a cycle..
+                get_solver().get_sat_core().value(t_atm.sigma) == utils::False ||             // we cannot unify with an atom that is unified with another atom..
+                get_solver().get_sat_core().value(t_atm.reason->get_phi()) == utils::False || // we cannot unify with an atom that cannot be activated..
+                !get_solver().matches(atm, riddle::expr(t_atm_ptr)))                          // we cannot unify with an atom that does not match the current atom..
+                continue;
+
+            c_targets.push_back(t_atm_ptr);
+        }
+
+        std::vector<atom *> overflow;
+        if (const auto cap = get_solver().get_unification_cap(static_cast<riddle::predicate &>(c_atm.get_type())); cap && c_targets.size() > cap)
+        { // we keep the most promising targets, postponing the others to an overflow flaw..
+            get_solver().unif_idx.rank(c_atm, c_targets);
+            overflow.assign(c_targets.cbegin() + cap, c_targets.cend());
+            c_targets.resize(cap);
+        }
+
+        std::vector<resolver_ptr> u_res;
+        u_res.reserve(c_targets.size() + 1);
+        for (const auto &t_atm_ptr : c_targets)
+        {
+            riddle::expr t_atm(t_atm_ptr);
+            // the equality propositional literal, built eagerly since the theories accept new constraints only at root-level (notice, however, that it is built only for the targets which survived the above filters and the unification cap)..
+            auto eq_lit = static_cast<bool_item &>(*get_solver().eq(atm, t_atm)).get_lit();
+
+            if (get_solver().get_sat_core().value(eq_lit) == utils::False)
+                continue; // the two atoms cannot unify, hence, we skip this target..
+
+            LOG("found possible unification with " << to_string(*t_atm_ptr) << "..");
+
+            // we add the resolver..
+            u_res.emplace_back(new unify_atom(f, *this, t_atm, eq_lit));
+        }
+        if (!overflow.empty())
+        {
+            LOG("postponing " << std::to_string(overflow.size()) << " unifications..");
+            u_res.emplace_back(new unify_overflow(f, *this, std::move(overflow)));
+        }
+        return u_res;
+    }
+
     json::json atom_flaw::get_data() const noexcept { return {{"type", "atom"}, {"atom", {{"id", get_id(*atm)}, {"is_fact", static_cast<atom &>(*atm).is_fact()}, {"type", atm->get_type().get_name()}, {"sigma", variable(static_cast<atom &>(*atm).sigma)}}}}; }
 
+    atom_flaw::unification_overflow::unification_overflow(solver &s, std::vector<std::reference_wrapper<resolver>> causes, atom_flaw &af, std::vector<atom *> targets) : flaw(s, causes), af(af), targets(std::move(targets)) {}
+
+    void atom_flaw::unification_overflow::compute_resolvers()
+    {
+        assert(get_solver().get_sat_core().value(get_phi()) != utils::False);
+        if (get_solver().get_sat_core().value(static_cast<atom &>(*af.get_atom()).sigma) == utils::Undefined) // the atom can still unify..
+            for (auto &u_res : af.compute_unifications(*this, std::move(targets)))
+                add_resolver(std::move(u_res));
+    }
+
+    json::json atom_flaw::unification_overflow::get_data() const noexcept { return {{"type", "unification_overflow"}, {"atom", get_id(*af.get_atom())}}; }
+
     atom_flaw::activate_fact::activate_fact(atom_flaw &ef) : resolver(ef, utils::rational::ZERO) {}
     atom_flaw::activate_fact::activate_fact(atom_flaw &ef, const semitone::lit &l) : resolver(ef, l, utils::rational::ZERO) {}
 
@@ -90,11 +142,10 @@ namespace ratio
 
     json::json atom_flaw::activate_goal::get_data() const noexcept { return {{"type", "activate_goal"}, {"rho", variable(get_rho())}}; }
 
-    atom_flaw::unify_atom::unify_atom(atom_flaw &ef, riddle::expr target, const semitone::lit &unif_lit) : resolver(ef, utils::rational::ZERO), target(target), unif_lit(unif_lit) {}
+    atom_flaw::unify_atom::unify_atom(flaw &f, atom_flaw &af, riddle::expr target, const semitone::lit &unif_lit) : resolver(f, utils::rational::ZERO), af(af), target(target), unif_lit(unif_lit) {}
 
     void atom_flaw::unify_atom::apply()
     {
-        auto &af = static_cast<const atom_flaw &>(get_flaw());
         auto &c_atm = static_cast<atom &>(*af.get_atom());
         auto &t_atm = static_cast<atom &>(*target);
         assert(get_solver().get_sat_core().value(c_atm.sigma) != utils::True);  // the current atom must be unifiable..
@@ -123,4 +174,14 @@ namespace ratio
     }
 
     json::json atom_flaw::unify_atom::get_data() const noexcept { return {{"type", "unify_atom"}, {"rho", variable(get_rho())}, {"target", get_id(*target)}}; }
+
+    atom_flaw::unify_overflow::unify_overflow(flaw &f, atom_flaw &af, std::vector<atom *> targets) : resolver(f, utils::rational::ZERO), af(af), targets(std::move(targets)) {}
+
+    void atom_flaw::unify_overflow::apply()
+    { // the remaining unifications are considered by a new flaw, which is expanded only if needed..
+        assert(get_solver().get_sat_core().value(get_rho()) != utils::False);
+        get_solver().new_flaw(new unification_overflow(get_solver(), get_solver().get_cause(), af, std::move(targets)));
+    }
+
+    json::json atom_flaw::unify_overflow::get_data() const noexcept { return {{"type", "unify_overflow"}, {"rho", variable(get_rho())}, {"targets", targets.size()}}; }
 } // namespace ratio
@@ -2,6 +2,16 @@
 #include "solver.h"
 #include <cassert>
 
+#ifndef GRAPH_MAX_FLAWS
+#define GRAPH_MAX_FLAWS 0
+#endif
+#ifndef GRAPH_MAX_RESOLVERS
+#define GRAPH_MAX_RESOLVERS 0
+#endif
+#ifndef GRAPH_MAX_SIZE
+#define GRAPH_MAX_SIZE 0
+#endif
+
 namespace ratio
 {
     graph::graph(solver &s) : s(s) {}
@@ -22,13 +32,9 @@ namespace ratio
             // we create a new gamma variable..
             reset_gamma();
             if (!s.get_active_flaws().empty())
-            { // we check if we have an estimated solution for the current problem..
-                if (std::any_of(s.get_active_flaws().cbegin(), s.get_active_flaws().cend(), [](const auto &f)
-                                { return is_positive_infinite(f->get_estimated_cost()); }))
-                    build(); // we build/extend the graph..
-                else
-                    add_layer(); // we add a layer to the current graph..
-            }
+                // we build/extend the graph if we do not have an estimated solution for the current problem, otherwise we add a layer to the current graph..
+                grow(std::none_of(s.get_active_flaws().cbegin(), s.get_active_flaws().cend(), [](const auto &f)
+                                  { return is_positive_infinite(f->get_estimated_cost()); }));
         }
 #ifdef GRAPH_PRUNING
         prune(); // we prune the graph..
@@ -51,11 +57,65 @@ namespace ratio
         assert(!s.get_sat_core().root_level());
     }
 
+    void graph::grow(const bool &layer)
+    {
+        if (exhausted) // the graph has already exceeded its budget, hence it cannot be further expanded..
+            throw budget_exceeded_exception();
+
+        try
+        {
+            if (layer)
+                add_layer();
+            else
+                build();
+        }
+        catch (const budget_exceeded_exception &)
+        {
+            LOG("the causal graph budget has been exceeded..");
+            exhausted = true;
+            if (std::any_of(s.get_active_flaws().cbegin(), s.get_active_flaws().cend(), [](const auto &f)
+                            { return is_positive_infinite(f->get_estimated_cost()); }))
+                throw; // we do not know how to solve some of the flaws, hence we cannot search on the current graph..
+            // we search on the current graph..
+            if (!s.get_sat_core().simplify_db())
+                throw riddle::unsolvable_exception();
+        }
+    }
+
+    void graph::check_budget() const
+    {
+        const auto exceeds = [](const size_t &n, const size_t &cap)
+        { return cap && n >= cap; }; // a zero cap means unbounded..
+        if (exceeds(n_flaws, GRAPH_MAX_FLAWS) || exceeds(n_resolvers, GRAPH_MAX_RESOLVERS) || exceeds(size, GRAPH_MAX_SIZE))
+            throw budget_exceeded_exception();
+    }
+
+    flaw &graph::select_flaw()
+    {
+        assert(!s.get_active_flaws().empty());
+        return **std::min_element(s.get_active_flaws().cbegin(), s.get_active_flaws().cend(), [](const auto &f0, const auto &f1)
+                                  { return f0->get_estimated_cost() > f1->get_estimated_cost(); });
+    }
+
     void graph::expand_flaw(flaw &f)
     {
         // we expand the flaw..
         s.expand_flaw(f);
 
+        // we update the size of the graph..
+        ++n_flaws;
+        ++size;
+        for (const auto &r : f.get_resolvers())
+        { // the preconditions are counted as causal links, since they are counted as flaws once they get expanded..
+            ++n_resolvers;
+            size += 1 + r.get().get_preconditions().size();
+        }
+
+        // the flaws supporting the new resolvers might have changed their deferrability..
+        for (const auto &r : f.get_resolvers())
+            for (const auto &p : r.get().get_preconditions())
+                invalidate_deferrable(p.get());
+
         // we propagate the costs starting from the just expanded flaw..
         propagate_costs(f);
     }
@@ -69,11 +129,41 @@ namespace ratio
 
     void graph::new_flaw(flaw_ptr f, const bool &enqueue) const noexcept { s.new_flaw(std::move(f), enqueue); }
 
-    const std::unordered_map<semitone::var, std::vector<flaw_ptr>> &graph::get_flaws() const noexcept { return s.get_flaws(); }
+    const std::vector<std::vector<flaw_ptr>> &graph::get_flaws() const noexcept { return s.get_flaws(); }
     const std::unordered_set<flaw *> &graph::get_active_flaws() const noexcept { return s.get_active_flaws(); }
-    const std::unordered_map<semitone::var, std::vector<resolver_ptr>> &graph::get_resolvers() const noexcept { return s.get_resolvers(); }
+    const std::vector<std::vector<resolver_ptr>> &graph::get_resolvers() const noexcept { return s.get_resolvers(); }
+
+    void graph::set_cost(flaw &f, const cost_t &cost) noexcept
+    {
+        s.set_cost(f, cost);
+        invalidate_deferrable(f);
+    }
+    cost_t graph::get_cost(const flaw &f) const noexcept { return s.get_sat_core().value(f.get_phi()) == utils::False ? positive_infinite_cost() : f.get_best_resolver().get_estimated_cost(); }
 
-    void graph::set_cost(flaw &f, const utils::rational &cost) const noexcept { s.set_cost(f, cost); }
+    void graph::invalidate_deferrable(flaw &f)
+    {
+        if (!defs.erase(&f))
+            return; // the deferrability of the flaw has not been computed, hence neither has the one of the flaws depending on it..
+        std::vector<flaw *> q{&f};
+        while (!q.empty())
+        {
+            auto &c_f = *q.back();
+            q.pop_back();
+            for (const auto &r : c_f.get_resolvers())
+                for (const auto &p : r.get().get_preconditions())
+                    if (defs.erase(&p.get()))
+                        q.push_back(&p.get());
+        }
+    }
+
+    bool graph::probe(const std::vector<semitone::lit> &lits)
+    {
+        const auto c_learnt = n_learnt;
+        for (const auto &l : lits)
+            if (s.get_sat_core().value(l) == utils::Undefined && !s.get_sat_core().check({l}))
+                ++n_learnt;
+        return n_learnt > c_learnt;
+    }
 
     std::vector<std::vector<std::pair<semitone::lit, double>>> graph::get_incs() const noexcept { return s.get_incs(); }
 } // namespace ratio
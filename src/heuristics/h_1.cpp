@@ -2,81 +2,131 @@
 #include "solver.h"
 #include "enum_flaw.h"
 #include "atom_flaw.h"
+#include <queue>
+#include <chrono>
 #include <cassert>
 
+#ifndef ENUM_PRUNING_BUDGET
+#define ENUM_PRUNING_BUDGET 0
+#endif
+
 namespace ratio
 {
     h_1::h_1(solver &s) : graph(s) {}
 
-    void h_1::enqueue(flaw &f) { flaw_q.push_back(&f); }
+    void h_1::enqueue(flaw &f)
+    {
+        // the expansion priority of the flaw is given by its cheapest causal path (i.e., its causal depth plus the intrinsic costs of its causes) from the root flaws..
+        cost_t priority = f.get_causes().empty() ? zero_cost() : positive_infinite_cost();
+        for (const auto &c : f.get_causes())
+        {
+            const auto p_it = priorities.find(&c.get().get_flaw());
+            priority = std::min(priority, (p_it != priorities.cend() ? p_it->second : zero_cost()) + cost_t(1) + to_cost(c.get().get_intrinsic_cost()));
+        }
+        priorities.emplace(&f, priority);
+        flaw_q.push_back(&f);
+    }
 
     void h_1::propagate_costs(flaw &f)
     {
-        // the current flaw's cost..
-        utils::rational c_cost = s.get_sat_core().value(f.get_phi()) == utils::False ? utils::rational::POSITIVE_INFINITY : f.get_best_resolver().get_estimated_cost();
-
+        const auto c_cost = get_cost(f); // the current flaw's cost..
         if (f.get_estimated_cost() == c_cost)
             return; // nothing to propagate..
-        else if (visited.count(&f))
-        { // we are propagating costs within a causal cycle..
-            c_cost = utils::rational::POSITIVE_INFINITY;
-            if (f.get_estimated_cost() == c_cost)
-                return; // nothing to propagate..
+
+        std::vector<flaw *> c_flaws; // the flaws whose cost has to be recomputed..
+        if (f.get_estimated_cost() < c_cost)
+        { // the cost of the flaw increased, hence we invalidate the costs of the flaws which might depend on it..
+            set_cost(f, positive_infinite_cost());
+            c_flaws.push_back(&f);
+            for (size_t i = 0; i < c_flaws.size(); ++i)
+                for (const auto &supp : c_flaws[i]->get_supports())
+                    if (s.get_sat_core().value(supp.get().get_rho()) != utils::False)
+                        if (auto &supp_f = supp.get().get_flaw(); supp_f.get_estimated_cost() < get_cost(supp_f))
+                        { // the cost of the `supp_f` flaw was supported by an invalidated flaw..
+                            set_cost(supp_f, positive_infinite_cost());
+                            c_flaws.push_back(&supp_f);
+                        }
         }
+        else
+            c_flaws.push_back(&f);
+
+        // we propagate the costs in increasing order, as in Dijkstra's algorithm, so that each flaw is settled once..
+        const auto cmp = [](const std::pair<cost_t, flaw *> &lhs, const std::pair<cost_t, flaw *> &rhs)
+        { return lhs.first > rhs.first; };
+        std::priority_queue<std::pair<cost_t, flaw *>, std::vector<std::pair<cost_t, flaw *>>, decltype(cmp)> cost_q(cmp);
+        for (const auto &c_f : c_flaws)
+            if (const auto cost = get_cost(*c_f); cost < c_f->get_estimated_cost())
+                cost_q.emplace(cost, c_f);
+        while (!cost_q.empty())
+        {
+            const auto [cost, c_f] = cost_q.top();
+            cost_q.pop();
+            if (c_f->get_estimated_cost() <= cost)
+                continue; // the flaw has already been settled..
 
-        // we update the cost of the flaw..
-        set_cost(f, c_cost);
+            // we update the cost of the flaw..
+            set_cost(*c_f, cost);
 
-        // we (try to) update the estimated costs of the supports' effects and enqueue them for cost propagation..
-        visited.insert(&f);
-        for (const auto &supp : f.get_supports())
-            if (s.get_sat_core().value(supp.get().get_rho()) != utils::False)
-                propagate_costs(supp.get().get_flaw());
-        visited.erase(&f);
+            // we (try to) update the estimated costs of the supports' effects and enqueue them for cost propagation..
+            for (const auto &supp : c_f->get_supports())
+                if (s.get_sat_core().value(supp.get().get_rho()) != utils::False)
+                    if (auto &supp_f = supp.get().get_flaw(); get_cost(supp_f) < supp_f.get_estimated_cost())
+                        cost_q.emplace(get_cost(supp_f), &supp_f);
+        }
     }
 
     void h_1::build()
     {
         LOG("building the causal graph..");
         assert(s.get_sat_core().root_level());
+        defs.clear(); // we recompute the deferrability of the flaws at each building round..
+#ifdef LAZY_GRAPH
+        return; // the causal graph is expanded lazily, while searching, through the `expand_subgraph` method..
+#endif
 
         do
         {
+            // we expand the flaws in best-first order, the most promising (i.e., the ones with the lowest priority) first..
+            std::priority_queue<std::tuple<cost_t, size_t, flaw *>, std::vector<std::tuple<cost_t, size_t, flaw *>>, std::greater<>> exp_q;
+            size_t n_q = 0;               // the number of flaws of the flaw queue which have been added to the expansion queue..
+            size_t n_exp = 0;             // the number of insertions into the expansion queue (used for breaking ties in FIFO order)..
+            std::vector<flaw *> deferred; // the flaws which have been deferred..
             while (std::any_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](const auto &f)
                                { return is_positive_infinite(f->get_estimated_cost()); }))
             {
-                if (flaw_q.empty()) // we have no flaws to expand..
-                    throw riddle::unsolvable_exception();
+                // we add the newly enqueued flaws to the expansion queue..
+                for (; n_q < flaw_q.size(); ++n_q)
+                    exp_q.emplace(get_priority(*flaw_q[n_q]), n_exp++, flaw_q[n_q]);
+                if (exp_q.empty())
+                { // we reconsider the deferred flaws..
+                    if (deferred.empty()) // we have no flaws to expand..
+                        throw riddle::unsolvable_exception();
+                    for (const auto &d_f : deferred)
+                        exp_q.emplace(get_priority(*d_f), n_exp++, d_f);
+                    deferred.clear();
+                }
 
-                // we expand the flaw at the front of the queue..
-                auto &f = *flaw_q.front();
+                // we expand the most promising flaw..
+                auto &f = *std::get<2>(exp_q.top());
+                exp_q.pop();
                 assert(!f.is_expanded());
                 if (s.get_sat_core().value(f.get_phi()) != utils::False)
                 {
 #ifdef DEFERRABLE_FLAWS
                     if (is_deferrable(f))
-                        flaw_q.push_back(&f);
+                        deferred.push_back(&f);
                     else
 #endif
-                    {
-                        expand_flaw(f);
-#ifdef GRAPH_REFINING
-                        if (auto e_f = dynamic_cast<enum_flaw *>(&f))
-                            enum_flaws.push_back(e_f);
-                        else if (auto a_f = dynamic_cast<atom_flaw *>(&f))
-                            for (const auto &r : a_f->get_resolvers())
-                                if (atom_flaw::is_unification(r.get()))
-                                {
-                                    auto &l = static_cast<atom_flaw &>(r.get().get_preconditions().front().get());
-                                    if (s.get_sat_core().value(l.get_phi()) == utils::Undefined)
-                                        landmarks.insert(&l);
-                                }
-#endif
-                    }
+                        expand(f);
                 }
-                flaw_q.pop_front();
             }
 
+            // we remove the expanded (and the negated) flaws from the flaw queue..
+            clean_queue();
+
+            // we check the expanded graph..
+            check_round();
+
             // we extract the inconsistencies (and translate them into flaws)..
             get_incs();
 #ifdef GRAPH_REFINING
@@ -94,6 +144,14 @@ namespace ratio
     {
         LOG("adding a layer to the causal graph..");
         assert(s.get_sat_core().root_level());
+#ifdef LAZY_GRAPH
+#ifdef GRAPH_PRUNING
+        // the graph expanded so far has no solution, hence we leave the unexpanded flaws open for the new graph variable, so that the search can expand them lazily..
+        open_frontier = true;
+#endif
+        return; // the causal graph is expanded lazily, while searching, through the `expand_subgraph` method..
+#endif
+        defs.clear(); // we recompute the deferrability of the flaws at each building round..
         assert(std::none_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](flaw *f)
                             { return is_positive_infinite(f->get_estimated_cost()); }));
 
@@ -113,24 +171,16 @@ namespace ratio
                 auto &f = *flaw_q.front();
                 assert(!f.is_expanded());
                 if (s.get_sat_core().value(f.get_phi()) != utils::False)
-                {
-                    expand_flaw(f);
-#ifdef GRAPH_REFINING
-                    if (auto e_f = dynamic_cast<enum_flaw *>(&f))
-                        enum_flaws.push_back(e_f);
-                    else if (auto a_f = dynamic_cast<atom_flaw *>(&f))
-                        for (const auto &r : a_f->get_resolvers())
-                            if (atom_flaw::is_unification(r.get()))
-                            {
-                                auto &l = static_cast<atom_flaw &>(r.get().get_preconditions().front().get());
-                                if (s.get_sat_core().value(l.get_phi()) == utils::Undefined)
-                                    landmarks.insert(&l);
-                            }
-#endif
-                }
+                    expand(f);
                 flaw_q.pop_front();
             }
 
+            // we forget the priorities of the expanded (and of the negated) flaws..
+            clean_queue();
+
+            // we check the expanded graph..
+            check_round();
+
             // we extract the inconsistencies (and translate them into flaws)..
             get_incs();
 #ifdef GRAPH_REFINING
@@ -147,18 +197,66 @@ namespace ratio
                 throw riddle::unsolvable_exception();
     }
 
+    void h_1::expand(flaw &f)
+    {
+        check_budget();
+        expand_flaw(f);
+#ifdef GRAPH_REFINING
+        if (auto e_f = dynamic_cast<enum_flaw *>(&f))
+            enum_flaws.push_back(e_f);
+        else if (atom_flaw::is_unifying(f))
+            for (const auto &r : f.get_resolvers())
+                if (atom_flaw::is_unification(r.get()))
+                {
+                    auto &l = static_cast<atom_flaw &>(r.get().get_preconditions().front().get());
+                    if (s.get_sat_core().value(l.get_phi()) == utils::Undefined)
+                        landmarks.insert(&l);
+                }
+#endif
+    }
+
+    cost_t h_1::get_priority(const flaw &f) const noexcept
+    {
+        const auto p_it = priorities.find(&f);
+        return p_it != priorities.cend() ? p_it->second : f.get_estimated_cost(); // flaws which have not been enqueued (e.g., the ones directly expanded) are prioritized by their estimated cost..
+    }
+
+    void h_1::clean_queue()
+    {
+        const auto is_done = [this](const flaw *f)
+        { return f->is_expanded() || s.get_sat_core().value(f->get_phi()) == utils::False; };
+        flaw_q.erase(std::remove_if(flaw_q.begin(), flaw_q.end(), is_done), flaw_q.end());
+        // the priorities are required only for enqueuing the preconditions of the resolvers of the flaws being expanded, hence we keep only the ones of the enqueued flaws..
+        for (auto p_it = priorities.begin(); p_it != priorities.end();)
+            if (is_done(p_it->first))
+                p_it = priorities.erase(p_it);
+            else
+                ++p_it;
+    }
+
 #ifdef GRAPH_PRUNING
     void h_1::prune()
     {
         LOG("pruning the causal graph..");
         assert(s.get_sat_core().root_level());
+#ifdef LAZY_GRAPH
+        // we prune the graph expanded so far only if it provides an estimated solution for the current problem (otherwise, the unexpanded flaws will be expanded lazily while searching)..
+        if (open_frontier || std::any_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](flaw *f)
+                                         { return is_positive_infinite(f->get_estimated_cost()); }))
+            return;
+#else
         assert(std::none_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](flaw *f)
                             { return is_positive_infinite(f->get_estimated_cost()); }));
+#endif
 
         for (const auto &f : flaw_q)
-            if (already_closed.insert(f).second)
-                if (!s.get_sat_core().new_clause({semitone::lit(get_gamma(), false), !f->get_phi()}))
-                    throw riddle::unsolvable_exception();
+            if (!f->is_expanded()) // the flaw queue might contain expanded flaws if the building procedure has been interrupted..
+                if (const auto [c_it, added] = already_closed.emplace(f, get_gamma()); added || c_it->second != get_gamma())
+                { // the flaw has not been closed for the current graph variable yet..
+                    c_it->second = get_gamma();
+                    if (!s.get_sat_core().new_clause({semitone::lit(get_gamma(), false), !f->get_phi()}))
+                        throw riddle::unsolvable_exception();
+                }
         if (!s.get_sat_core().propagate())
             throw riddle::unsolvable_exception();
     }
@@ -172,39 +270,147 @@ namespace ratio
         std::vector<atom_flaw *> c_landmarks(landmarks.begin(), landmarks.end());
         std::sort(c_landmarks.begin(), c_landmarks.end(), [](const auto &l1, const auto &l2)
                   { return l1->get_estimated_cost() > l2->get_estimated_cost(); });
-        for (auto l : c_landmarks)
-        {
-            if (s.get_sat_core().value(l->get_phi()) == utils::Undefined)
-                s.get_sat_core().check({!l->get_phi()});
-            if (s.get_sat_core().value(l->get_phi()) != utils::Undefined)
+        std::vector<semitone::lit> lits;
+        lits.reserve(c_landmarks.size());
+        for (const auto &l : c_landmarks)
+            lits.push_back(!l->get_phi());
+        probe(lits);
+
+        // we discard the decided landmarks, notifying the found ones..
+        for (const auto &l : c_landmarks)
+            switch (s.get_sat_core().value(l->get_phi()))
+            {
+            case utils::True:
+                new_landmark(*l);
+                [[fallthrough]];
+            case utils::False:
                 landmarks.erase(l);
-        }
+                break;
+            default:
+                break;
+            }
     }
 
     void h_1::prune_enums()
     {
         LOG("checking enums..");
+        const auto n_decided = [this](enum_flaw &e_f)
+        { return static_cast<size_t>(std::count_if(e_f.get_resolvers().cbegin(), e_f.get_resolvers().cend(), [this](const auto &r)
+                                                   { return s.get_sat_core().value(r.get().get_rho()) != utils::Undefined; })); };
+
+        // we collect the enums which might have been affected by the root-level facts since they have been last probed..
+        std::vector<enum_flaw *> c_enums;
+        for (const auto &e_f : enum_flaws)
+            if (const auto p_it = probed_enums.find(e_f); p_it == probed_enums.cend() || p_it->second != std::make_pair(n_decided(*e_f), n_learnt))
+                c_enums.push_back(e_f);
+
         // we sort the enums by decreasing estimated cost..
-        std::sort(enum_flaws.begin(), enum_flaws.end(), [](const auto &e1, const auto &e2)
+        std::sort(c_enums.begin(), c_enums.end(), [](const auto &e1, const auto &e2)
                   { return e1->get_estimated_cost() > e2->get_estimated_cost(); });
-        for (auto e_f : enum_flaws)
-            for (auto &r : e_f->get_resolvers())
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto &e_f : c_enums)
+        {
+            if (ENUM_PRUNING_BUDGET && std::chrono::steady_clock::now() - start > std::chrono::milliseconds(ENUM_PRUNING_BUDGET))
+            { // the remaining enums will be probed at the next building round..
+                LOG("enum pruning budget exhausted..");
+                break;
+            }
+            std::vector<semitone::lit> lits;
+            for (const auto &r : e_f->get_resolvers())
                 if (s.get_sat_core().value(r.get().get_rho()) == utils::Undefined)
-                    s.get_sat_core().check({r.get().get_rho()});
+                    lits.push_back(r.get().get_rho());
+            probe(lits);
+            probed_enums[e_f] = {n_decided(*e_f), n_learnt};
+        }
+
+        // we discard the enum flaws whose resolvers have all been decided (at root-level, they will not be undecided anymore)..
+        enum_flaws.erase(std::remove_if(enum_flaws.begin(), enum_flaws.end(), [&n_decided](const auto &e_f)
+                                        { return n_decided(*e_f) == e_f->get_resolvers().size(); }),
+                         enum_flaws.end());
+        for (auto p_it = probed_enums.begin(); p_it != probed_enums.end();)
+            if (n_decided(*p_it->first) == p_it->first->get_resolvers().size())
+                p_it = probed_enums.erase(p_it);
+            else
+                ++p_it;
+    }
+#endif
+
+#ifdef LAZY_GRAPH
+    bool h_1::is_expandable(flaw &f) { return !get_unexpanded(f).empty(); }
+
+    void h_1::expand_subgraph(flaw &f)
+    {
+        LOG("expanding the causal subgraph of flaw " << to_string(f) << "..");
+        assert(s.get_sat_core().root_level());
+
+        // we expand the unexpanded flaws of the subgraph in best-first order, the most promising (i.e., the ones with the lowest priority) first..
+        std::priority_queue<std::tuple<cost_t, size_t, flaw *>, std::vector<std::tuple<cost_t, size_t, flaw *>>, std::greater<>> exp_q;
+        size_t n_exp = 0; // the number of insertions into the expansion queue (used for breaking ties in FIFO order)..
+        for (const auto &u_f : get_unexpanded(f))
+            exp_q.emplace(get_priority(*u_f), n_exp++, u_f);
+        while (!exp_q.empty() && is_positive_infinite(f.get_estimated_cost()))
+        {
+            auto &c_f = *std::get<2>(exp_q.top());
+            exp_q.pop();
+            if (c_f.is_expanded() || s.get_sat_core().value(c_f.get_phi()) == utils::False)
+                continue; // the flaw has already been expanded (or it is not relevant anymore)..
+
+            expand(c_f);
+
+            // the subgraph now includes the preconditions of the resolvers of the expanded flaw..
+            for (const auto &r : c_f.get_resolvers())
+                if (s.get_sat_core().value(r.get().get_rho()) != utils::False)
+                    for (const auto &p : r.get().get_preconditions())
+                        if (!p.get().is_expanded())
+                            exp_q.emplace(get_priority(p.get()), n_exp++, &p.get());
+        }
+
+        // we remove the expanded (and the negated) flaws from the flaw queue..
+        clean_queue();
+#ifdef GRAPH_PRUNING
+        open_frontier = false; // the graph has grown, hence we can prune it again..
+#endif
+#ifdef GRAPH_REFINING
+        prune_enums();
+#endif
+    }
+
+    std::vector<flaw *> h_1::get_unexpanded(flaw &f)
+    {
+        std::vector<flaw *> unexpanded;
+        std::unordered_set<flaw *> c_visited{&f};
+        std::vector<flaw *> q{&f};
+        while (!q.empty())
+        {
+            auto &c_f = *q.back();
+            q.pop_back();
+            if (s.get_sat_core().value(c_f.get_phi()) == utils::False)
+                continue; // the flaw cannot be part of a solution..
+            if (!c_f.is_expanded())
+                unexpanded.push_back(&c_f);
+            else
+                for (const auto &r : c_f.get_resolvers())
+                    if (s.get_sat_core().value(r.get().get_rho()) != utils::False)
+                        for (const auto &p : r.get().get_preconditions())
+                            if (c_visited.insert(&p.get()).second)
+                                q.push_back(&p.get());
+        }
+        return unexpanded;
     }
 #endif
 
     bool h_1::is_deferrable(flaw &f)
     {
-        if (f.get_estimated_cost() < utils::rational::POSITIVE_INFINITY || std::any_of(f.get_resolvers().cbegin(), f.get_resolvers().cend(), [this](auto &r)
+        if (const auto def_it = defs.find(&f); def_it != defs.cend())
+            return def_it->second; // we have already checked this flaw..
+        if (!is_positive_infinite(f.get_estimated_cost()) || std::any_of(f.get_resolvers().cbegin(), f.get_resolvers().cend(), [this](auto &r)
                                                                                        { return s.get_sat_core().value(r.get().get_rho()) == utils::True; }))
-            return true; // we already have a possible solution for this flaw, thus we defer..
-        if (s.get_sat_core().value(f.get_phi()) == utils::True || visited.count(&f))
-            return false; // we necessarily have to solve this flaw: it cannot be deferred..
-        visited.insert(&f);
-        bool def = std::all_of(f.get_supports().cbegin(), f.get_supports().cend(), [this](auto &r)
-                               { return is_deferrable(r.get().get_flaw()); });
-        visited.erase(&f);
-        return def;
+            return defs[&f] = true; // we already have a possible solution for this flaw, thus we defer..
+        if (s.get_sat_core().value(f.get_phi()) == utils::True)
+            return defs[&f] = false; // we necessarily have to solve this flaw: it cannot be deferred..
+        defs[&f] = false; // we are checking this flaw: if we reach it again we are within a causal cycle, hence it cannot be deferred..
+        const bool def = std::all_of(f.get_supports().cbegin(), f.get_supports().cend(), [this](auto &r)
+                                     { return is_deferrable(r.get().get_flaw()); });
+        return defs[&f] = def;
     }
 } // namespace ratio
\ No newline at end of file
@@ -1,219 +1,34 @@
 #include "h_2.h"
 #include "solver.h"
-#include "enum_flaw.h"
-#include "atom_flaw.h"
 #include <cassert>
 
 namespace ratio
 {
-    h_2::h_2(solver &s) : graph(s) {}
-
-    void h_2::enqueue(flaw &f) { flaw_q.push_back(&f); }
-
-    void h_2::propagate_costs(flaw &f)
+    namespace
     {
-        // the current flaw's cost..
-        utils::rational c_cost = s.get_sat_core().value(f.get_phi()) == utils::False ? utils::rational::POSITIVE_INFINITY : f.get_best_resolver().get_estimated_cost();
-
-        if (f.get_estimated_cost() == c_cost)
-            return; // nothing to propagate..
-        else if (visited.count(&f))
-        { // we are propagating costs within a causal cycle..
-            c_cost = utils::rational::POSITIVE_INFINITY;
-            if (f.get_estimated_cost() == c_cost)
-                return; // nothing to propagate..
-        }
+        size_t lit_index(const semitone::lit &l) noexcept { return variable(l) << 1 | !sign(l); } // the index of the given literal, distinguishing its sign..
+    } // namespace
 
-        // we update the cost of the flaw..
-        set_cost(f, c_cost);
+    h_2::h_2(solver &s) : h_1(s) {}
 
-        // we (try to) update the estimated costs of the supports' effects and enqueue them for cost propagation..
-        visited.insert(&f);
-        for (const auto &supp : f.get_supports())
-            if (s.get_sat_core().value(supp.get().get_rho()) != utils::False)
-                propagate_costs(supp.get().get_flaw());
-        visited.erase(&f);
-    }
-
-    void h_2::build()
+    void h_2::check_round()
     {
-        LOG("building the causal graph..");
-        assert(s.get_sat_core().root_level());
-
-        do
+        bool sol = false;
+        while (!sol)
         {
-            while (std::any_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](const auto &f)
-                               { return is_positive_infinite(f->get_estimated_cost()); }))
-            {
-                if (flaw_q.empty()) // we have no more flaws to expand..
-                    throw riddle::unsolvable_exception();
-
-                // we expand the flaw at the front of the queue..
-                auto &f = *flaw_q.front();
-                assert(!f.is_expanded());
-                if (s.get_sat_core().value(f.get_phi()) != utils::False)
+            sol = true;
+            // we visit the flaws whose cost, or whose resolvers, have changed since they have been last found solvable..
+            for (auto &f : std::vector<flaw *>(get_active_flaws().begin(), get_active_flaws().end()))
+                if (const auto c_it = checked.find(f); c_it == checked.cend() || c_it->second.first != f->get_estimated_cost() || c_it->second.second != f->get_resolvers().size())
                 {
-#ifdef DEFERRABLE_FLAWS
-                    if (is_deferrable(f))
-                        flaw_q.push_back(&f);
+                    if (visit(*f))
+                        checked[f] = {f->get_estimated_cost(), f->get_resolvers().size()};
                     else
-#endif
                     {
-                        expand_flaw(f);
-#ifdef GRAPH_REFINING
-                        if (auto e_f = dynamic_cast<enum_flaw *>(&f))
-                            enum_flaws.push_back(e_f);
-                        else if (auto a_f = dynamic_cast<atom_flaw *>(&f))
-                            for (const auto &r : a_f->get_resolvers())
-                                if (atom_flaw::is_unification(r.get()))
-                                {
-                                    auto &l = static_cast<atom_flaw &>(r.get().get_preconditions().front().get());
-                                    if (s.get_sat_core().value(l.get_phi()) == utils::Undefined)
-                                        landmarks.insert(&l);
-                                }
-#endif
+                        checked.erase(f);
+                        sol = false;
                     }
                 }
-                flaw_q.pop_front();
-            }
-
-            // we check the graph for mutexes..
-            check();
-
-            // we extract the inconsistencies (and translate them into flaws)..
-            get_incs();
-#ifdef GRAPH_REFINING
-            prune_enums();
-#endif
-        } while (std::any_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](const auto &f)
-                             { return is_positive_infinite(f->get_estimated_cost()); }));
-
-        // we perform some cleanings..
-        if (!s.get_sat_core().simplify_db())
-            throw riddle::unsolvable_exception();
-    }
-
-    void h_2::add_layer()
-    {
-        LOG("adding a layer to the causal graph..");
-        assert(s.get_sat_core().root_level());
-        assert(std::none_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](flaw *f)
-                            { return is_positive_infinite(f->get_estimated_cost()); }));
-
-        // we make a copy of the flaws queue..
-        auto f_q = flaw_q;
-        assert(std::all_of(f_q.cbegin(), f_q.cend(), [this](auto f)
-                           { return is_deferrable(*f); }));
-        while (std::all_of(f_q.cbegin(), f_q.cend(), [](auto f)
-                           { return is_infinite(f->get_estimated_cost()); }))
-        {
-            if (flaw_q.empty()) // we have no more flaws to expand..
-                throw riddle::unsolvable_exception();
-            // we expand all the flaws in the queue..
-            auto q_size = flaw_q.size();
-            for (size_t i = 0; i < q_size; ++i)
-            {
-                auto &f = *flaw_q.front();
-                assert(!f.is_expanded());
-                if (s.get_sat_core().value(f.get_phi()) != utils::False)
-                {
-                    expand_flaw(f);
-#ifdef GRAPH_REFINING
-                    if (auto e_f = dynamic_cast<enum_flaw *>(&f))
-                        enum_flaws.push_back(e_f);
-                    else if (auto a_f = dynamic_cast<atom_flaw *>(&f))
-                        for (const auto &r : a_f->get_resolvers())
-                            if (atom_flaw::is_unification(r.get()))
-                            {
-                                auto &l = static_cast<atom_flaw &>(r.get().get_preconditions().front().get());
-                                if (s.get_sat_core().value(l.get_phi()) == utils::Undefined)
-                                    landmarks.insert(&l);
-                            }
-#endif
-                }
-                flaw_q.pop_front();
-            }
-
-            // we check the graph for mutexes..
-            check();
-
-            // we clear the enqueued flaws..
-            c_res = nullptr;
-            h_2_flaws.clear();
-
-            // we extract the inconsistencies (and translate them into flaws)..
-            get_incs();
-#ifdef GRAPH_REFINING
-            prune_enums();
-#endif
-        }
-
-        // we check if we can further build the causal graph..
-        if (std::any_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](const auto &f)
-                        { return is_positive_infinite(f->get_estimated_cost()); }))
-            build();
-        else // we perform some cleanings..
-            if (!s.get_sat_core().simplify_db())
-                throw riddle::unsolvable_exception();
-    }
-
-#ifdef GRAPH_PRUNING
-    void h_2::prune()
-    {
-        LOG("pruning the causal graph..");
-        assert(s.get_sat_core().root_level());
-        assert(std::none_of(get_active_flaws().cbegin(), get_active_flaws().cend(), [](flaw *f)
-                            { return is_positive_infinite(f->get_estimated_cost()); }));
-
-        for (const auto &f : flaw_q)
-            if (already_closed.insert(f).second)
-                if (!s.get_sat_core().new_clause({semitone::lit(get_gamma(), false), !f->get_phi()}))
-                    throw riddle::unsolvable_exception();
-        if (!s.get_sat_core().propagate())
-            throw riddle::unsolvable_exception();
-    }
-#endif
-
-#ifdef GRAPH_REFINING
-    void h_2::refine()
-    {
-        LOG("checking landmarks..");
-        // we sort the landmarks by decreasing estimated cost..
-        std::vector<atom_flaw *> c_landmarks(landmarks.begin(), landmarks.end());
-        std::sort(c_landmarks.begin(), c_landmarks.end(), [](const auto &l1, const auto &l2)
-                  { return l1->get_estimated_cost() > l2->get_estimated_cost(); });
-        for (auto l : c_landmarks)
-        {
-            if (s.get_sat_core().value(l->get_phi()) == utils::Undefined)
-                s.get_sat_core().check({!l->get_phi()});
-            if (s.get_sat_core().value(l->get_phi()) != utils::Undefined)
-                landmarks.erase(l);
-        }
-    }
-
-    void h_2::prune_enums()
-    {
-        LOG("checking enums..");
-        // we sort the enums by decreasing estimated cost..
-        std::sort(enum_flaws.begin(), enum_flaws.end(), [](const auto &e1, const auto &e2)
-                  { return e1->get_estimated_cost() > e2->get_estimated_cost(); });
-        for (auto e_f : enum_flaws)
-            for (auto &r : e_f->get_resolvers())
-                if (s.get_sat_core().value(r.get().get_rho()) == utils::Undefined)
-                    s.get_sat_core().check({r.get().get_rho()});
-    }
-#endif
-
-    void h_2::check()
-    {
-        bool sol = false;
-        while (!sol)
-        {
-            sol = true;
-            // we visit the flaws..
-            for (auto &f : std::vector<flaw *>(get_active_flaws().begin(), get_active_flaws().end()))
-                if (!visit(*f))
-                    sol = false;
 
             if (pending_flaws.empty())
                 break;
@@ -237,21 +52,7 @@ namespace ratio
                         auto &f = *flaw_q.front();
                         assert(!f.is_expanded());
                         if (s.get_sat_core().value(f.get_phi()) != utils::False)
-                        {
-                            expand_flaw(f);
-#ifdef GRAPH_REFINING
-                            if (auto e_f = dynamic_cast<enum_flaw *>(&f))
-                                enum_flaws.push_back(e_f);
-                            else if (auto a_f = dynamic_cast<atom_flaw *>(&f))
-                                for (const auto &r : a_f->get_resolvers())
-                                    if (atom_flaw::is_unification(r.get()))
-                                    {
-                                        auto &l = static_cast<atom_flaw &>(r.get().get_preconditions().front().get());
-                                        if (s.get_sat_core().value(l.get_phi()) == utils::Undefined)
-                                            landmarks.insert(&l);
-                                    }
-#endif
-                        }
+                            expand(f);
                         flaw_q.pop_front();
                     }
                 }
@@ -262,6 +63,12 @@ namespace ratio
 
         assert(s.get_sat_core().root_level());
 
+        // we prune the mutually exclusive resolvers..
+        for (const auto &[r0, r1] : new_mutexes)
+            if (!s.get_sat_core().new_clause({!r0, !r1}))
+                throw riddle::unsolvable_exception();
+        new_mutexes.clear();
+
         // we add the h_2 flaws..
         for (auto &f : h_2_flaws)
             new_flaw(f, false);
@@ -325,35 +132,64 @@ namespace ratio
         return solvable;
     }
 
+    void h_2::activated_flaw(flaw &f)
+    {
+        invalidate_checked();
+        h_1::activated_flaw(f);
+    }
+
+    void h_2::negated_flaw(flaw &f)
+    {
+        invalidate_checked();
+        h_1::negated_flaw(f);
+    }
+
+    void h_2::activated_resolver(resolver &r)
+    {
+        invalidate_checked();
+        h_1::activated_resolver(r);
+    }
+
     void h_2::negated_resolver(resolver &r) // resolver c_res is mutex with r!
     {
-        if (c_res != nullptr &&                                        // we are checking the graph..
-            c_res != &r &&                                             // the current resolver is not the negated resolver..
-            get_active_flaws().count(&r.get_flaw()) &&                 // the negated resolver's flaw is active (and not already solved)..
-            s.get_sat_core().value(c_res->get_rho()) == utils::True && // the current resolver is active..
-            (!mutexes.count(c_res) || !mutexes.at(c_res).count(&r)))   // the resolvers are not already mutex..
+        if (s.get_sat_core().root_level())
+            invalidate_checked();
+        else if (c_res != nullptr &&                                             // we are checking the graph..
+                 c_res != &r &&                                                  // the current resolver is not the negated resolver..
+                 get_active_flaws().count(&r.get_flaw()) &&                      // the negated resolver's flaw is active (and not already solved)..
+                 s.get_sat_core().get_decisions().size() == 1 &&                 // the current resolver is the only assumption..
+                 s.get_sat_core().get_decisions().front() == c_res->get_rho() && // hence it is the reason for the negation..
+                 !is_mutex(c_res->get_rho(), r.get_rho()))                       // the resolvers are not already mutex..
         {
             LOG("adding mutex between " << to_string(*c_res) << " and " << to_string(r) << "..");
-            mutexes[&r].insert(c_res);
-            mutexes[c_res].insert(&r);
+            add_mutex(r.get_rho(), c_res->get_rho());
+            add_mutex(c_res->get_rho(), r.get_rho());
+            new_mutexes.emplace_back(c_res->get_rho(), r.get_rho());
         }
 
         // we refine the graph..
-        graph::negated_resolver(r);
+        h_1::negated_resolver(r);
     }
 
-    bool h_2::is_deferrable(flaw &f)
+    void h_2::invalidate_checked() noexcept
     {
-        if (f.get_estimated_cost() < utils::rational::POSITIVE_INFINITY || std::any_of(f.get_resolvers().cbegin(), f.get_resolvers().cend(), [this](auto &r)
-                                                                                       { return s.get_sat_core().value(r.get().get_rho()) == utils::True; }))
-            return true; // we already have a possible solution for this flaw, thus we defer..
-        if (s.get_sat_core().value(f.get_phi()) == utils::True || visited.count(&f))
-            return false; // we necessarily have to solve this flaw: it cannot be deferred..
-        visited.insert(&f);
-        bool def = std::all_of(f.get_supports().cbegin(), f.get_supports().cend(), [this](auto &r)
-                               { return is_deferrable(r.get().get_flaw()); });
-        visited.erase(&f);
-        return def;
+        if (s.get_sat_core().root_level()) // the root-level facts have changed, hence the previously checked flaws have to be checked again..
+            checked.clear();
+    }
+
+    bool h_2::is_mutex(const semitone::lit &r0, const semitone::lit &r1) const noexcept
+    {
+        const auto r0_idx = lit_index(r0);
+        return r0_idx < mutexes.size() && std::binary_search(mutexes[r0_idx].cbegin(), mutexes[r0_idx].cend(), lit_index(r1));
+    }
+
+    void h_2::add_mutex(const semitone::lit &r0, const semitone::lit &r1)
+    {
+        const auto r0_idx = lit_index(r0);
+        if (mutexes.size() <= r0_idx)
+            mutexes.resize(r0_idx + 1);
+        auto &r0_mtxs = mutexes[r0_idx];
+        r0_mtxs.insert(std::lower_bound(r0_mtxs.begin(), r0_mtxs.end(), lit_index(r1)), lit_index(r1));
     }
 
     h_2::h_2_flaw::h_2_flaw(flaw &sub_f, resolver &r, resolver &mtx_r) : flaw(sub_f.get_solver(), {r}), sub_f(sub_f), mtx_r(mtx_r) {}
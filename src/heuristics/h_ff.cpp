@@ -0,0 +1,124 @@
+#include "h_ff.h"
+#include "solver.h"
+#include <cassert>
+
+namespace ratio
+{
+    h_ff::h_ff(solver &s) : h_1(s) {}
+
+    flaw &h_ff::select_flaw()
+    {
+        assert(!get_active_flaws().empty());
+        // we select the flaws we do not know how to solve first, so that the search procedure can take care of them..
+        if (const auto inf_it = std::find_if(get_active_flaws().cbegin(), get_active_flaws().cend(), [](const auto &f)
+                                             { return is_infinite(f->get_estimated_cost()); });
+            inf_it != get_active_flaws().cend())
+            return **inf_it;
+
+        // we select the flaw having the most expensive relaxed plan..
+        extract_plans();
+        flaw *best_flaw = nullptr;
+        cost_t best_cost = negative_infinite_cost();
+        for (const auto &f : get_active_flaws())
+            if (const auto c_cost = plans.at(f).second; c_cost > best_cost)
+            {
+                best_flaw = f;
+                best_cost = c_cost;
+            }
+        return *best_flaw;
+    }
+
+    resolver &h_ff::select_resolver(flaw &f)
+    {
+        assert(!is_infinite(f.get_estimated_cost()));
+        // we collect the resolvers of the relaxed plans of the other active flaws..
+        extract_plans();
+        const auto &f_plan = plans.at(&f).first;
+        std::unordered_set<const resolver *> others;
+        for (const auto &[r, n] : n_plans)
+            if (n > f_plan.count(r))
+                others.insert(r);
+
+        // the helpful resolvers are those which add the least to the relaxed plan of the other flaws (i.e., those which share the most subgoals with it), among which we select the cheapest one..
+        resolver *best_res = nullptr;
+        cost_t best_cost = positive_infinite_cost();
+        for (const auto &r : f.get_resolvers())
+            if (!is_infinite(r.get().get_estimated_cost()))
+            {
+                std::unordered_set<const resolver *> plan;
+                if (const auto c_cost = extract_plan(r.get(), plan, &others); !best_res || c_cost < best_cost || (c_cost == best_cost && r.get().get_estimated_cost() < best_res->get_estimated_cost()))
+                {
+                    best_res = &r.get();
+                    best_cost = c_cost;
+                }
+            }
+        assert(best_res);
+        return *best_res;
+    }
+
+    void h_ff::push() { valid_plans = false; }
+    void h_ff::pop() { valid_plans = false; }
+
+    void h_ff::activated_flaw(flaw &f)
+    {
+        valid_plans = false;
+        h_1::activated_flaw(f);
+    }
+    void h_ff::negated_flaw(flaw &f)
+    {
+        valid_plans = false;
+        h_1::negated_flaw(f);
+    }
+    void h_ff::activated_resolver(resolver &r)
+    {
+        valid_plans = false;
+        h_1::activated_resolver(r);
+    }
+    void h_ff::negated_resolver(resolver &r)
+    {
+        valid_plans = false;
+        h_1::negated_resolver(r);
+    }
+
+    void h_ff::extract_plans()
+    {
+        if (valid_plans)
+            return; // nothing changed since the relaxed plans have been last extracted..
+
+        plans.clear();
+        n_plans.clear();
+        for (const auto &f : get_active_flaws())
+            if (!is_infinite(f->get_estimated_cost()))
+            {
+                auto &[plan, cost] = plans[f];
+                cost = extract_plan(f->get_best_resolver(), plan);
+                for (const auto &r : plan)
+                    ++n_plans[r];
+            }
+        valid_plans = true;
+    }
+
+    cost_t h_ff::extract_plan(resolver &r, std::unordered_set<const resolver *> &plan, const std::unordered_set<const resolver *> *shared) const
+    {
+        cost_t c_cost = zero_cost();
+        std::vector<resolver *> q{&r};
+        while (!q.empty())
+        {
+            auto &c_r = *q.back();
+            q.pop_back();
+            if ((shared && shared->count(&c_r)) || !plan.insert(&c_r).second)
+                continue; // the resolver is already in the plan, hence we do not count it again..
+            c_cost += to_cost(c_r.get_intrinsic_cost());
+            for (const auto &p : c_r.get_preconditions())
+                if (!is_solved(p.get()) && !is_infinite(p.get().get_estimated_cost()))
+                    q.push_back(&p.get().get_best_resolver());
+        }
+        return c_cost;
+    }
+
+    bool h_ff::is_solved(flaw &f) const noexcept
+    {
+        return std::any_of(f.get_resolvers().cbegin(), f.get_resolvers().cend(), [this](const auto &r)
+                           { return s.get_sat_core().value(r.get().get_rho()) == utils::True; });
+    }
+} // namespace ratio
@@ -0,0 +1,108 @@
+#include "h_lm.h"
+#include "solver.h"
+#include "atom_flaw.h"
+#include <cassert>
+
+namespace ratio
+{
+    h_lm::h_lm(solver &s) : h_1(s) {}
+
+#ifdef GRAPH_REFINING
+    void h_lm::new_landmark(atom_flaw &l)
+    {
+        // cheaper landmarks are (likely) required for achieving the more expensive ones, hence they come first..
+        lms.insert(std::upper_bound(lms.begin(), lms.end(), &l, [](const auto &l0, const auto &l1)
+                                    { return l0->get_estimated_cost() < l1->get_estimated_cost(); }),
+                   &l);
+        valid_supports = false;
+        LOG("found landmark " << to_string(l) << " (" << std::to_string(lms.size()) << " landmarks)");
+    }
+#endif
+
+    flaw &h_lm::select_flaw()
+    {
+        assert(!get_active_flaws().empty());
+        // we select the flaws we do not know how to solve first, so that the search procedure can take care of them..
+        if (const auto inf_it = std::find_if(get_active_flaws().cbegin(), get_active_flaws().cend(), [](const auto &f)
+                                             { return is_infinite(f->get_estimated_cost()); });
+            inf_it != get_active_flaws().cend())
+            return **inf_it;
+
+        // we select the flaw whose causal subgraph, following the best resolvers, contains the earliest unachieved landmark, preferring the flaws whose subgraphs contain the most unachieved landmarks and, then, the most expensive ones in case of ties..
+        compute_supports();
+        flaw *best_flaw = nullptr;
+        size_t best_first = lms.size(), best_count = 0;
+        for (const auto &f : get_active_flaws())
+        {
+            size_t c_first = lms.size(), c_count = 0;
+            if (const auto s_it = lm_supports.find(f); s_it != lm_supports.cend())
+                std::tie(c_first, c_count) = s_it->second;
+            if (!best_flaw || c_first < best_first || (c_first == best_first && (c_count > best_count || (c_count == best_count && f->get_estimated_cost() > best_flaw->get_estimated_cost()))))
+            {
+                best_flaw = f;
+                best_first = c_first;
+                best_count = c_count;
+            }
+        }
+        return *best_flaw;
+    }
+
+    void h_lm::push() { valid_supports = false; }
+    void h_lm::pop() { valid_supports = false; }
+
+    void h_lm::activated_flaw(flaw &f)
+    {
+        valid_supports = false;
+        h_1::activated_flaw(f);
+    }
+    void h_lm::negated_flaw(flaw &f)
+    {
+        valid_supports = false;
+        h_1::negated_flaw(f);
+    }
+    void h_lm::activated_resolver(resolver &r)
+    {
+        valid_supports = false;
+        h_1::activated_resolver(r);
+    }
+    void h_lm::negated_resolver(resolver &r)
+    {
+        valid_supports = false;
+        h_1::negated_resolver(r);
+    }
+
+    void h_lm::compute_supports()
+    {
+        if (valid_supports)
+            return; // nothing changed since the landmark supports have been last computed..
+
+        lm_supports.clear();
+        size_t pos = 0; // the position of the current landmark within the order of the unachieved landmarks..
+        for (const auto &l : lms)
+            if (!is_achieved(*l))
+            {
+                // we climb the causal graph from the landmark, following the best resolvers backward, collecting the flaws whose causal subgraph contains it..
+                std::unordered_set<const flaw *> c_visited{l};
+                std::vector<flaw *> q{l};
+                while (!q.empty())
+                {
+                    auto &c_f = *q.back();
+                    q.pop_back();
+                    ++lm_supports.try_emplace(&c_f, pos, 0).first->second.second; // landmarks are climbed from in order, hence the first one reaching a flaw is its earliest one..
+                    for (const auto &supp : c_f.get_supports())
+                        if (auto &supp_f = supp.get().get_flaw(); supp_f.is_expanded() && !is_infinite(supp_f.get_estimated_cost()) && &supp_f.get_best_resolver() == &supp.get() && c_visited.insert(&supp_f).second)
+                            q.push_back(&supp_f);
+                }
+                ++pos;
+            }
+        valid_supports = true;
+    }
+
+    bool h_lm::is_achieved(const atom_flaw &l) const noexcept
+    {
+        if (s.get_sat_core().value(l.get_phi()) != utils::True)
+            return true; // the landmark is not required anymore (e.g., we have backtracked before it was found)..
+        return std::any_of(l.get_resolvers().cbegin(), l.get_resolvers().cend(), [this](const auto &r)
+                           { return s.get_sat_core().value(r.get().get_rho()) == utils::True; });
+    }
+} // namespace ratio
@@ -0,0 +1,103 @@
+#include "memory_pool.h"
+#include <array>
+#include <new>
+
+namespace ratio
+{
+    namespace
+    {
+        constexpr size_t ALIGNMENT = alignof(std::max_align_t);       // the alignment (and granularity) of the blocks..
+        constexpr size_t MAX_BLOCK_SIZE = 512;                        // the size of the largest size class..
+        constexpr size_t N_SIZE_CLASSES = MAX_BLOCK_SIZE / ALIGNMENT; // the number of size classes..
+        constexpr size_t CHUNK_SIZE = 64 * 1024;                      // the size of the chunks the blocks are carved out of (including their header)..
+
+        struct free_block
+        {
+            free_block *next;
+        };
+
+        struct chunk_header
+        {
+            chunk_header *next;
+        };
+
+        struct size_class
+        {
+            free_block *free_list = nullptr; // the released blocks, ready to be recycled..
+            char *c_ptr = nullptr;           // the first unused byte of the current chunk..
+            char *c_end = nullptr;           // the end of the current chunk..
+        };
+
+        // the pool is trivially destructible, so that blocks can still be released during the destruction of the thread's storage..
+        struct pool
+        {
+            std::array<size_class, N_SIZE_CLASSES> classes; // the size classes..
+            chunk_header *chunks = nullptr;                 // the chunks allocated so far, linked through their headers..
+            size_t n_users = 0;                             // the number of live users of the pool..
+        };
+
+        thread_local pool t_pool;
+
+        constexpr size_t get_class(const size_t &size) noexcept { return size ? (size - 1) / ALIGNMENT : 0; }
+        constexpr size_t HEADER_SIZE = ((sizeof(chunk_header) + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT; // the size of the chunk headers, preserving the alignment of the blocks..
+    } // namespace
+
+    ORATIOSOLVER_EXPORT void *memory_pool::allocate(const size_t &size)
+    {
+        if (size > MAX_BLOCK_SIZE)
+            return ::operator new(size);
+
+        auto &sc = t_pool.classes[get_class(size)];
+        if (sc.free_list)
+        { // we recycle a released block..
+            auto blk = sc.free_list;
+            sc.free_list = blk->next;
+            return blk;
+        }
+
+        const size_t blk_size = (get_class(size) + 1) * ALIGNMENT;
+        if (sc.c_ptr + blk_size > sc.c_end)
+        { // we need a new chunk..
+            auto chnk = static_cast<chunk_header *>(::operator new(CHUNK_SIZE));
+            chnk->next = t_pool.chunks;
+            t_pool.chunks = chnk;
+            sc.c_ptr = reinterpret_cast<char *>(chnk) + HEADER_SIZE;
+            sc.c_end = reinterpret_cast<char *>(chnk) + CHUNK_SIZE;
+        }
+        auto blk = sc.c_ptr;
+        sc.c_ptr += blk_size;
+        return blk;
+    }
+
+    ORATIOSOLVER_EXPORT void memory_pool::deallocate(void *ptr, const size_t &size) noexcept
+    {
+        if (!ptr)
+            return;
+        if (size > MAX_BLOCK_SIZE)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        auto &sc = t_pool.classes[get_class(size)];
+        auto blk = static_cast<free_block *>(ptr);
+        blk->next = sc.free_list;
+        sc.free_list = blk;
+    }
+
+    ORATIOSOLVER_EXPORT memory_pool::user::user() noexcept { t_pool.n_users++; }
+    ORATIOSOLVER_EXPORT memory_pool::user::~user()
+    {
+        if (--t_pool.n_users)
+            return;
+
+        // the last user is gone, hence no block is in use anymore and we can release the chunks as a whole..
+        while (t_pool.chunks)
+        {
+            auto chnk = t_pool.chunks;
+            t_pool.chunks = chnk->next;
+            ::operator delete(chnk);
+        }
+        t_pool.classes = {};
+    }
+} // namespace ratio
@@ -6,33 +6,33 @@
 namespace ratio
 {
     resolver::resolver(flaw &f, const utils::rational &cost) : resolver(f, semitone::lit(f.s.sat->new_var()), cost) {}
-    resolver::resolver(flaw &f, const semitone::lit &rho, const utils::rational &cost) : f(f), rho(rho), intrinsic_cost(cost) { assert(f.s.get_sat_core().value(rho) != utils::False); }
+    resolver::resolver(flaw &f, const semitone::lit &rho, const utils::rational &cost) : f(f), rho(rho), intrinsic_cost(cost), est_cost(to_cost(cost)) { assert(f.s.get_sat_core().value(rho) != utils::False); }
 
-    utils::rational resolver::get_estimated_cost() const noexcept
+    cost_t resolver::compute_estimated_cost() const noexcept
     {
         if (get_solver().get_sat_core().value(rho) == utils::False)
-            return utils::rational::POSITIVE_INFINITY;
+            return positive_infinite_cost();
         else if (preconditions.empty())
-            return intrinsic_cost;
+            return to_cost(intrinsic_cost);
 
-        utils::rational est_cost;
-#if defined(H_MAX) || defined(H2_MAX)
-        est_cost = utils::rational::NEGATIVE_INFINITY;
+        cost_t est_cost;
+#if defined(H_MAX) || defined(H2_MAX) || defined(H_LM)
+        est_cost = negative_infinite_cost();
         for (const auto &p : preconditions)
             if (!p.get().is_expanded())
-                return utils::rational::POSITIVE_INFINITY;
+                return positive_infinite_cost();
             else // we compute the max of the flaws' estimated costs..
                 est_cost = std::max(est_cost, p.get().get_estimated_cost());
 #endif
-#if defined(H_ADD) || defined(H2_ADD)
-        est_cost = utils::rational::ZERO;
+#if defined(H_ADD) || defined(H2_ADD) || defined(H_FF)
+        est_cost = zero_cost();
         for (const auto &p : preconditions)
             if (!p.get().is_expanded())
-                return utils::rational::POSITIVE_INFINITY;
+                return positive_infinite_cost();
             else // we compute the sum of the flaws' estimated costs..
                 est_cost += p.get().get_estimated_cost();
 #endif
-        return est_cost + intrinsic_cost;
+        return est_cost + to_cost(intrinsic_cost);
     }
 
     void resolver::new_causal_link(flaw &f) { f.s.new_causal_link(f, *this); }
@@ -28,22 +28,32 @@ namespace ratio
         return res;
     }
 
+    atom_record::atom_record(atom &atm, const riddle::expr &start, const riddle::expr &end, const riddle::expr &tau, const riddle::expr &amount) : atm(&atm), start(start), end(end), tau(tau), tau_enum(static_cast<solver &>(atm.get_type().get_core()).get_kind(*tau) == enum_kind ? static_cast<enum_item *>(tau.operator->()) : nullptr), amount(amount) {}
+
     atom_listener::atom_listener(atom &atm) : lra_value_listener(static_cast<solver &>(atm.get_type().get_core()).get_lra_theory()), rdl_value_listener(static_cast<solver &>(atm.get_type().get_core()).get_rdl_theory()), ov_value_listener(static_cast<solver &>(atm.get_type().get_core()).get_ov_theory()), atm(atm)
     {
         listen_sat(variable(atm.get_sigma()));
+        const auto &slv = static_cast<solver &>(atm.get_type().get_core());
         for (const auto &[xpr_name, xpr] : atm.get_vars())
-            if (!static_cast<solver &>(atm.get_type().get_core()).is_constant(xpr))
-            {
-                if (xpr->get_type() == static_cast<solver &>(atm.get_type().get_core()).get_bool_type())
+            if (!slv.is_constant(xpr))
+                switch (slv.get_kind(*xpr))
+                {
+                case bool_kind:
                     listen_sat(variable(static_cast<const bool_item &>(*xpr).get_lit()));
-                else if (xpr->get_type() == static_cast<solver &>(atm.get_type().get_core()).get_int_type() || xpr->get_type() == static_cast<solver &>(atm.get_type().get_core()).get_real_type())
+                    break;
+                case arith_kind:
                     for (const auto &l : static_cast<const arith_item &>(*xpr).get_lin().vars)
                         listen_lra(l.first);
-                else if (xpr->get_type() == static_cast<solver &>(atm.get_type().get_core()).get_time_type())
+                    break;
+                case time_kind:
                     for (const auto &l : static_cast<const arith_item &>(*xpr).get_lin().vars)
                         listen_rdl(l.first);
-                else if (auto *ov = dynamic_cast<const enum_item *>(&*xpr))
-                    listen_set(ov->get_var());
-            }
+                    break;
+                case enum_kind:
+                    listen_set(static_cast<const enum_item &>(*xpr).get_var());
+                    break;
+                default:
+                    break;
+                }
     }
 } // namespace ratio
@@ -15,21 +15,43 @@
 #elif defined(H2_MAX) || defined(H2_ADD)
 #include "h_2.h"
 #define HEURISTIC new h_2(*this)
+#elif defined(H_FF)
+#include "h_ff.h"
+#define HEURISTIC new h_ff(*this)
+#elif defined(H_LM)
+#include "h_lm.h"
+#define HEURISTIC new h_lm(*this)
 #endif
 #ifdef BUILD_LISTENERS
 #include "solver_listener.h"
 #endif
 #include <cassert>
 
+#ifndef UNIFICATION_CAP
+#define UNIFICATION_CAP 0
+#endif
+
 namespace ratio
 {
+    arith_item::~arith_item()
+    {
+        if (interned) // we remove this item from the solver's table of linear expressions..
+            static_cast<solver &>(get_type().get_core()).lins.erase({&get_type(), &l});
+    }
+
     ORATIOSOLVER_EXPORT solver::solver(const bool &i) : solver(HEURISTIC, i) {}
-    ORATIOSOLVER_EXPORT solver::solver(graph_ptr g, const bool &i) : countable(true), theory(new semitone::sat_core()), lra_th(sat), ov_th(sat), idl_th(sat), rdl_th(sat), gr(std::move(g))
+    ORATIOSOLVER_EXPORT solver::solver(graph_ptr g, const bool &i) : countable(true), theory(new semitone::sat_core()), unif_idx(*this), unif_cap(UNIFICATION_CAP), lra_th(sat), ov_th(sat), idl_th(sat), rdl_th(sat), gr(std::move(g))
     {
         gr->reset_gamma();
         if (i) // we initializa the solver..
             init();
     }
+    ORATIOSOLVER_EXPORT solver::~solver()
+    {
+        // the items might outlive the table of the linear expressions (e.g., they might be destroyed by the core), hence we detach them..
+        for (auto &[l, xpr] : lins)
+            xpr->interned = false;
+    }
 
     ORATIOSOLVER_EXPORT void solver::init()
     {
@@ -47,6 +69,8 @@ namespace ratio
 
     ORATIOSOLVER_EXPORT void solver::read(const std::string &script)
     {
+        // the field layouts are recomputed, since the read types might have changed..
+        field_layouts.clear();
         // we read the script..
         core::read(script);
         // we reset the smart-types if some new smart-type has been added with the previous script..
@@ -58,6 +82,8 @@ namespace ratio
     }
     ORATIOSOLVER_EXPORT void solver::read(const std::vector<std::string> &files)
     {
+        // the field layouts are recomputed, since the read types might have changed..
+        field_layouts.clear();
         // we read the files..
         core::read(files);
         // we reset the smart-types if some new smart-type has been added with the previous files..
@@ -88,7 +114,7 @@ namespace ratio
     ORATIOSOLVER_EXPORT riddle::expr solver::new_string() { return new string_item(get_string_type()); }
     ORATIOSOLVER_EXPORT riddle::expr solver::new_string(const std::string &value) { return new string_item(get_string_type(), value); }
 
-    riddle::expr solver::new_item(riddle::complex_type &tp) { return new riddle::complex_item(tp); }
+    riddle::expr solver::new_item(riddle::complex_type &tp) { return new complex_item(tp); }
 
     ORATIOSOLVER_EXPORT riddle::expr solver::new_enum(riddle::type &tp, const std::vector<riddle::expr> &xprs)
     {
@@ -104,7 +130,7 @@ namespace ratio
             std::vector<utils::enum_val *> vals;
             vals.reserve(xprs.size());
             for (auto &xpr : xprs)
-                if (auto ev = dynamic_cast<utils::enum_val *>(xpr.operator->()))
+                if (auto ev = get_enum_val(*xpr))
                     vals.push_back(ev);
                 else
                     throw std::runtime_error("invalid enum expression");
@@ -120,8 +146,9 @@ namespace ratio
 
     riddle::expr solver::get_enum(riddle::expr &xpr, const std::string &name)
     {
-        if (auto enum_expr = dynamic_cast<enum_item *>(xpr.operator->()))
+        if (get_kind(*xpr) == enum_kind)
         { // we retrieve the domain of the enum variable..
+            auto enum_expr = static_cast<enum_item *>(xpr.operator->());
             auto vs = ov_th.value(enum_expr->get_var());
             assert(vs.size() > 1);
             std::unordered_map<riddle::item *, std::vector<semitone::lit>> val_vars;
@@ -257,7 +284,7 @@ namespace ratio
                     l += static_cast<arith_item &>(*xpr).get_lin();
                 else
                     throw std::runtime_error("the expression must be an integer or a real");
-            return new arith_item(get_type(xprs), l);
+            return new_lin(get_type(xprs), std::move(l));
         }
     }
 
@@ -266,7 +293,7 @@ namespace ratio
         if (xprs.empty())
             throw std::runtime_error("the expression must be an integer or a real");
         else if (xprs.size() == 1)
-            return new arith_item(get_type(xprs), -static_cast<arith_item &>(*xprs[0]).get_lin());
+            return new_lin(get_type(xprs), -static_cast<arith_item &>(*xprs[0]).get_lin());
         else
         {
             semitone::lin l = static_cast<arith_item &>(*xprs[0]).get_lin();
@@ -275,7 +302,7 @@ namespace ratio
                     l -= static_cast<arith_item &>(*xprs[i]).get_lin();
                 else
                     throw std::runtime_error("the expression must be an integer or a real");
-            return new arith_item(get_type(xprs), l);
+            return new_lin(get_type(xprs), std::move(l));
         }
     }
 
@@ -300,7 +327,7 @@ namespace ratio
                         assert(lra_th.value(static_cast<arith_item &>(*xpr).get_lin()).get_infinitesimal() == utils::rational::ZERO);
                         l *= lra_th.value(static_cast<arith_item &>(*xpr).get_lin()).get_rational();
                     }
-                return new arith_item(get_type(xprs), l);
+                return new_lin(get_type(xprs), std::move(l));
             }
             else
             {
@@ -310,7 +337,7 @@ namespace ratio
                     assert(lra_th.value(static_cast<arith_item &>(**xpr_it).get_lin()).get_infinitesimal() == utils::rational::ZERO);
                     l *= lra_th.value(static_cast<arith_item &>(**xpr_it).get_lin()).get_rational();
                 }
-                return new arith_item(get_type(xprs), l);
+                return new_lin(get_type(xprs), std::move(l));
             }
         }
     }
@@ -325,7 +352,7 @@ namespace ratio
             assert(lra_th.value(static_cast<arith_item &>(*xprs[0]).get_lin()).get_infinitesimal() == utils::rational::ZERO);
             semitone::lin l(utils::rational::ONE);
             l /= static_cast<arith_item &>(*xprs[0]).get_lin().known_term;
-            return new arith_item(get_type(xprs), l);
+            return new_lin(get_type(xprs), std::move(l));
         }
         else
         {
@@ -345,14 +372,14 @@ namespace ratio
                 }
                 else
                     throw std::runtime_error("the expression must be an integer or a real");
-            return new arith_item(get_type(xprs), l);
+            return new_lin(get_type(xprs), std::move(l));
         }
     }
 
     ORATIOSOLVER_EXPORT riddle::expr solver::minus(const riddle::expr &xpr)
     {
         if (xpr->get_type() == get_int_type() || xpr->get_type() == get_real_type() || xpr->get_type() == get_time_type())
-            return new arith_item(xpr->get_type(), -static_cast<arith_item &>(*xpr).get_lin());
+            return new_lin(xpr->get_type(), -static_cast<arith_item &>(*xpr).get_lin());
         else
             throw std::runtime_error("the expression must be an integer or a real");
     }
@@ -360,9 +387,9 @@ namespace ratio
     ORATIOSOLVER_EXPORT riddle::expr solver::lt(const riddle::expr &lhs, const riddle::expr &rhs)
     {
         if ((lhs->get_type() == get_int_type() || lhs->get_type() == get_real_type()) && (rhs->get_type() == get_int_type() || rhs->get_type() == get_real_type()))
-            return new bool_item(get_bool_type(), lra_th.new_lt(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_lt(lhs, rhs, false));
         else if (lhs->get_type() == get_time_type() && rhs->get_type() == get_time_type())
-            return new bool_item(get_bool_type(), rdl_th.new_lt(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_lt(lhs, rhs, true));
         else
             throw std::runtime_error("the expression must be an integer or a real");
     }
@@ -370,9 +397,9 @@ namespace ratio
     ORATIOSOLVER_EXPORT riddle::expr solver::leq(const riddle::expr &lhs, const riddle::expr &rhs)
     {
         if ((lhs->get_type() == get_int_type() || lhs->get_type() == get_real_type()) && (rhs->get_type() == get_int_type() || rhs->get_type() == get_real_type()))
-            return new bool_item(get_bool_type(), lra_th.new_leq(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_leq(lhs, rhs, false));
         else if (lhs->get_type() == get_time_type() && rhs->get_type() == get_time_type())
-            return new bool_item(get_bool_type(), rdl_th.new_leq(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_leq(lhs, rhs, true));
         else
             throw std::runtime_error("the expression must be an integer or a real");
     }
@@ -381,73 +408,40 @@ namespace ratio
     {
         if (lhs == rhs) // the two items are the same item..
             return new bool_item(get_bool_type(), semitone::TRUE_lit);
-        else if ((lhs->get_type() == get_int_type() || lhs->get_type() == get_real_type() || lhs->get_type() == get_time_type()) && (rhs->get_type() == get_int_type() || rhs->get_type() == get_real_type() || rhs->get_type() == get_time_type()))
+        const auto l_kind = get_kind(*lhs);
+        const auto r_kind = get_kind(*rhs);
+        if ((l_kind == arith_kind || l_kind == time_kind) && (r_kind == arith_kind || r_kind == time_kind))
         { // we are comparing two arithmetic expressions..
-            if (get_type({lhs, rhs}) == get_time_type())
-                return new bool_item(get_bool_type(), rdl_th.new_eq(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
-            else
-                return new bool_item(get_bool_type(), lra_th.new_eq(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_eq(lhs, rhs, get_type({lhs, rhs}) == get_time_type()));
         }
-        else if (lhs->get_type() == get_bool_type() && lhs->get_type() == rhs->get_type())
+        else if (l_kind == bool_kind && r_kind == bool_kind)
             return new bool_item(get_bool_type(), sat->new_eq(static_cast<bool_item &>(*lhs).get_lit(), static_cast<bool_item &>(*rhs).get_lit()));
-        else if (lhs->get_type() == get_string_type() && lhs->get_type() == rhs->get_type())
+        else if (l_kind == string_kind && r_kind == string_kind)
             return new bool_item(get_bool_type(), static_cast<string_item &>(*lhs).get_string() == static_cast<string_item &>(*rhs).get_string() ? semitone::TRUE_lit : semitone::FALSE_lit);
-        else if (auto lee = dynamic_cast<enum_item *>(lhs.operator->()))
-        {                                                               // we are comparing an enum with something else..
-            if (auto ree = dynamic_cast<enum_item *>(rhs.operator->())) // we are comparing enums..
-                return new bool_item(get_bool_type(), ov_th.new_eq(lee->get_var(), ree->get_var()));
+        else if (l_kind == enum_kind)
+        { // we are comparing an enum with something else..
+            auto &lee = static_cast<enum_item &>(*lhs);
+            if (r_kind == enum_kind) // we are comparing enums..
+                return new bool_item(get_bool_type(), ov_th.new_eq(lee.get_var(), static_cast<enum_item &>(*rhs).get_var()));
             else // we are comparing an enum with a singleton..
-                return new bool_item(get_bool_type(), ov_th.allows(lee->get_var(), dynamic_cast<utils::enum_val &>(*rhs)));
+                return new bool_item(get_bool_type(), ov_th.allows(lee.get_var(), *get_enum_val(*rhs)));
         }
-        else if (dynamic_cast<enum_item *>(rhs.operator->()))
+        else if (r_kind == enum_kind)
             return eq(rhs, lhs); // we swap, for simplifying code..
         else if (lhs->get_type() == rhs->get_type())
         { // we are comparing complex items..
-            auto leci = dynamic_cast<riddle::complex_item *>(lhs.operator->());
-            if (!leci)
-                throw std::runtime_error("the expression must be a complex item");
-            auto reci = dynamic_cast<riddle::complex_item *>(rhs.operator->());
-            if (!reci)
-                throw std::runtime_error("the expression must be a complex item");
+            const auto &layout = get_field_layout(lhs->get_type());
+            const auto &l_slots = get_slots(*lhs, layout);
+            const auto &r_slots = get_slots(*rhs, layout);
 
             std::vector<semitone::lit> eqs;
-            if (auto p = dynamic_cast<riddle::predicate *>(&lhs->get_type()))
+            eqs.reserve(l_slots.size());
+            for (size_t i = 0; i < l_slots.size(); ++i)
             {
-                std::queue<riddle::predicate *> q;
-                q.push(p);
-                while (!q.empty())
-                {
-                    for (const auto &[f_name, f] : q.front()->get_fields())
-                        if (!f->is_synthetic())
-                        {
-                            auto c_eq = eq(leci->get(f_name), reci->get(f_name));
-                            if (bool_value(c_eq) == utils::False)
-                                return new bool_item(get_bool_type(), semitone::FALSE_lit);
-                            eqs.push_back(static_cast<bool_item &>(*c_eq).get_lit());
-                        }
-                    for (const auto &stp : q.front()->get_parents())
-                        q.push(&stp.get());
-                    q.pop();
-                }
-            }
-            else if (auto ct = dynamic_cast<riddle::complex_type *>(&lhs->get_type()))
-            {
-                std::queue<riddle::complex_type *> q;
-                q.push(ct);
-                while (!q.empty())
-                {
-                    for (const auto &[f_name, f] : q.front()->get_fields())
-                        if (!f->is_synthetic())
-                        {
-                            auto c_eq = eq(leci->get(f_name), reci->get(f_name));
-                            if (bool_value(c_eq) == utils::False)
-                                return new bool_item(get_bool_type(), semitone::FALSE_lit);
-                            eqs.push_back(static_cast<bool_item &>(*c_eq).get_lit());
-                        }
-                    for (const auto &stp : q.front()->get_parents())
-                        q.push(&stp.get());
-                    q.pop();
-                }
+                auto c_eq = eq(riddle::expr(l_slots[i]), riddle::expr(r_slots[i]));
+                if (bool_value(c_eq) == utils::False)
+                    return new bool_item(get_bool_type(), semitone::FALSE_lit);
+                eqs.push_back(static_cast<bool_item &>(*c_eq).get_lit());
             }
             switch (eqs.size())
             {
@@ -466,9 +460,9 @@ namespace ratio
     ORATIOSOLVER_EXPORT riddle::expr solver::geq(const riddle::expr &lhs, const riddle::expr &rhs)
     {
         if ((lhs->get_type() == get_int_type() || lhs->get_type() == get_real_type()) && (rhs->get_type() == get_int_type() || rhs->get_type() == get_real_type()))
-            return new bool_item(get_bool_type(), lra_th.new_geq(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_leq(rhs, lhs, false));
         else if (lhs->get_type() == get_time_type() && rhs->get_type() == get_time_type())
-            return new bool_item(get_bool_type(), rdl_th.new_geq(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_leq(rhs, lhs, true));
         else
             throw std::runtime_error("the expression must be an integer or a real");
     }
@@ -476,72 +470,65 @@ namespace ratio
     ORATIOSOLVER_EXPORT riddle::expr solver::gt(const riddle::expr &lhs, const riddle::expr &rhs)
     {
         if ((lhs->get_type() == get_int_type() || lhs->get_type() == get_real_type()) && (rhs->get_type() == get_int_type() || rhs->get_type() == get_real_type()))
-            return new bool_item(get_bool_type(), lra_th.new_gt(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_lt(rhs, lhs, false));
         else if (lhs->get_type() == get_time_type() && rhs->get_type() == get_time_type())
-            return new bool_item(get_bool_type(), rdl_th.new_gt(static_cast<arith_item &>(*lhs).get_lin(), static_cast<arith_item &>(*rhs).get_lin()));
+            return new bool_item(get_bool_type(), new_lt(rhs, lhs, true));
         else
             throw std::runtime_error("the expression must be an integer or a real");
     }
 
-    bool solver::matches(const riddle::expr &lhs, const riddle::expr &rhs) const noexcept
+    bool solver::matches(const riddle::expr &lhs, const riddle::expr &rhs) const
     {
         if (lhs == rhs) // the two expressions are the same..
             return true;
-        else if (lhs->get_type() == get_bool_type() && rhs->get_type() == get_bool_type())
+        const auto l_kind = get_kind(*lhs);
+        const auto r_kind = get_kind(*rhs);
+        if (l_kind == bool_kind && r_kind == bool_kind)
         { // the two expressions are boolean..
             auto lbi = sat->value(static_cast<bool_item &>(*lhs).get_lit());
             auto rbi = sat->value(static_cast<bool_item &>(*rhs).get_lit());
             return lbi == rbi || lbi == utils::Undefined || rbi == utils::Undefined;
         }
-        else if ((lhs->get_type() == get_int_type() || lhs->get_type() == get_real_type() || lhs->get_type() == get_time_type()) && (rhs->get_type() == get_int_type() || rhs->get_type() == get_real_type() || rhs->get_type() == get_time_type()))
+        else if ((l_kind == arith_kind || l_kind == time_kind) && (r_kind == arith_kind || r_kind == time_kind))
         { // the two expressions are arithmetics..
-            auto lbi = static_cast<arith_item &>(*lhs).get_lin();
-            auto rbi = static_cast<arith_item &>(*rhs).get_lin();
-            if (lhs->get_type() == get_time_type() && rhs->get_type() == get_time_type()) // the two expressions are time arithmetics..
+            const auto &lbi = static_cast<arith_item &>(*lhs).get_lin();
+            const auto &rbi = static_cast<arith_item &>(*rhs).get_lin();
+            if (l_kind == time_kind && r_kind == time_kind) // the two expressions are time arithmetics..
                 return rdl_th.matches(lbi, rbi);
             else // the two expressions are integer or real arithmetics..
                 return lra_th.matches(lbi, rbi);
         }
-        else if (lhs->get_type() == get_string_type() && rhs->get_type() == get_string_type()) // the two expressions are strings..
+        else if (l_kind == string_kind && r_kind == string_kind) // the two expressions are strings..
             return static_cast<string_item &>(*lhs).get_string() == static_cast<string_item &>(*rhs).get_string();
-        else if (auto lee = dynamic_cast<enum_item *>(lhs.operator->()))
-        {                                                               // we are comparing an enum with something else..
-            auto lee_vals = ov_th.value(lee->get_var());                // get the values of the enum..
-            if (auto ree = dynamic_cast<enum_item *>(rhs.operator->())) // we are comparing enums..
+        else if (l_kind == enum_kind)
+        {                                                                          // we are comparing an enum with something else..
+            auto lee_vals = ov_th.value(static_cast<enum_item &>(*lhs).get_var()); // get the values of the enum..
+            if (r_kind == enum_kind)                                               // we are comparing enums..
             {
-                auto ree_vals = ov_th.value(ree->get_var()); // get the values of the enum..
+                auto ree_vals = ov_th.value(static_cast<enum_item &>(*rhs).get_var()); // get the values of the enum..
                 for (const auto &lv : lee_vals)
                     for (const auto &rv : ree_vals)
                         if (lv == rv)
                             return true;
                 return false;
             }
-            else // we are comparing an enum with a singleton..
+            else if (const auto r_val = get_enum_val(*rhs)) // we are comparing an enum with a singleton..
                 for (const auto &lv : lee_vals)
-                    if (lv == dynamic_cast<const utils::enum_val *>(rhs.operator->()))
+                    if (lv == r_val)
                         return true;
             return false;
         }
-        else if (dynamic_cast<enum_item *>(rhs.operator->()))
+        else if (r_kind == enum_kind)
             return matches(rhs, lhs); // we are comparing a singleton with an enum..
         else if (lhs->get_type() == rhs->get_type())
         { // we are comparing two complex items..
-            if (auto p = dynamic_cast<riddle::predicate *>(&lhs->get_type()))
+            if (const auto &layout = get_field_layout(lhs->get_type()); layout.atoms)
             { // we are comparing two atoms..
-                auto &leci = dynamic_cast<riddle::env &>(*lhs);
-                auto &reci = dynamic_cast<riddle::env &>(*rhs);
-                std::queue<riddle::predicate *> q;
-                q.push(p);
-                while (!q.empty())
-                {
-                    for (const auto &[f_name, f] : q.front()->get_fields())
-                        if (!f->is_synthetic())
-                            if (!matches(leci.get(f_name), reci.get(f_name)))
-                                return false;
-                    for (const auto &stp : q.front()->get_parents())
-                        q.push(&stp.get());
-                    q.pop();
-                }
+                const auto &l_slots = get_slots(*lhs, layout);
+                const auto &r_slots = get_slots(*rhs, layout);
+                for (size_t i = 0; i < l_slots.size(); ++i)
+                    if (!matches(riddle::expr(l_slots[i]), riddle::expr(r_slots[i])))
+                        return false;
                 return true;
             }
             else // the two items do not match..
@@ -551,6 +538,114 @@ namespace ratio
             return false;
     }
 
+    semitone::lit solver::new_constraint(const char &op, const bool &rdl, const riddle::expr &lhs, const riddle::expr &rhs)
+    {
+        const auto &l = static_cast<arith_item &>(*lhs).get_lin();
+        const auto &r = static_cast<arith_item &>(*rhs).get_lin();
+
+        // the constraint is normalized as `lhs - rhs op 0` (equalities being symmetric, the least between the difference and its opposite is taken)..
+        auto diff = l - r;
+        if (op == '=')
+            if (auto n_diff = -diff; lin_less()(n_diff, diff))
+                diff = std::move(n_diff);
+        auto &c_constraints = constraints[{op, rdl}];
+        if (const auto c_it = c_constraints.find(diff); c_it != c_constraints.cend())
+            return c_it->second;
+
+        semitone::lit c_lit;
+        switch (op)
+        {
+        case '<':
+            c_lit = rdl ? rdl_th.new_lt(l, r) : lra_th.new_lt(l, r);
+            break;
+        case '=':
+            c_lit = rdl ? rdl_th.new_eq(l, r) : lra_th.new_eq(l, r);
+            break;
+        default:
+            c_lit = rdl ? rdl_th.new_leq(l, r) : lra_th.new_leq(l, r);
+            break;
+        }
+
+        // constant literals might follow from the current bounds, hence we cache them only at root-level..
+        if (sat->root_level() || (c_lit != semitone::TRUE_lit && c_lit != semitone::FALSE_lit))
+            c_constraints.emplace(std::move(diff), c_lit);
+        return c_lit;
+    }
+
+    riddle::expr solver::new_lin(riddle::type &tp, semitone::lin &&l)
+    {
+        // linear expressions are immutable, hence we build only one item for each of them..
+        if (const auto l_it = lins.find({&tp, &l}); l_it != lins.cend())
+            return l_it->second;
+
+        auto xpr = new arith_item(tp, std::move(l));
+        xpr->interned = true;
+        lins.emplace(std::make_pair(&tp, &xpr->get_lin()), xpr);
+        return xpr;
+    }
+
+    bool solver::lin_less::operator()(const semitone::lin &l0, const semitone::lin &l1) const noexcept
+    {
+        if (l0.known_term != l1.known_term)
+            return l0.known_term < l1.known_term;
+        return l0.vars < l1.vars; // the variables are sorted, hence we compare them lexicographically..
+    }
+    bool solver::lin_less::operator()(const std::pair<const riddle::type *, const semitone::lin *> &l0, const std::pair<const riddle::type *, const semitone::lin *> &l1) const noexcept
+    {
+        if (l0.first != l1.first)
+            return l0.first < l1.first;
+        return (*this)(*l0.second, *l1.second);
+    }
+
+    const solver::field_layout &solver::get_field_layout(const riddle::type &tp) const
+    {
+        if (const auto l_it = field_layouts.find(&tp); l_it != field_layouts.cend())
+            return l_it->second;
+
+        // we collect the non-synthetic fields of the type, followed by those inherited from its parents (whose layouts are computed, and cached, first)..
+        field_layout layout;
+        const auto add_fields = [&layout](const riddle::complex_type &ct)
+        {
+            for (const auto &[f_name, f] : ct.get_fields())
+                if (!f->is_synthetic())
+                    layout.names.push_back(f_name);
+        };
+        if (auto p = dynamic_cast<const riddle::predicate *>(&tp))
+        {
+            layout.atoms = true;
+            add_fields(*p);
+            for (const auto &stp : p->get_parents())
+            {
+                const auto &p_names = get_field_layout(stp.get()).names;
+                layout.names.insert(layout.names.cend(), p_names.cbegin(), p_names.cend());
+            }
+        }
+        else if (auto ct = dynamic_cast<const riddle::complex_type *>(&tp))
+        {
+            add_fields(*ct);
+            for (const auto &stp : ct->get_parents())
+            {
+                const auto &p_names = get_field_layout(stp.get()).names;
+                layout.names.insert(layout.names.cend(), p_names.cbegin(), p_names.cend());
+            }
+        }
+        return field_layouts.emplace(&tp, std::move(layout)).first->second;
+    }
+
+    const std::vector<riddle::item *> &solver::get_slots(riddle::item &itm, const field_layout &layout) const
+    {
+        auto &slots = layout.atoms ? static_cast<atom &>(itm).slots : static_cast<complex_item &>(itm).slots;
+        if (slots.size() != layout.names.size())
+        { // we look up the values of the fields, once and for all..
+            auto &ci = static_cast<riddle::complex_item &>(itm);
+            slots.clear();
+            slots.reserve(layout.names.size());
+            for (const auto &f_name : layout.names)
+                slots.push_back(&*ci.get(f_name));
+        }
+        return slots;
+    }
+
     ORATIOSOLVER_EXPORT riddle::expr solver::conj(const std::vector<riddle::expr> &xprs)
     {
         std::vector<semitone::lit> lits;
@@ -647,7 +742,28 @@ namespace ratio
     ORATIOSOLVER_EXPORT utils::inf_rational solver::time_value(const riddle::expr &xpr) const { return rdl_th.bounds(static_cast<arith_item &>(*xpr).get_lin()).first; }
     ORATIOSOLVER_EXPORT std::pair<utils::inf_rational, utils::inf_rational> solver::time_bounds(const riddle::expr &xpr) const { return rdl_th.bounds(static_cast<arith_item &>(*xpr).get_lin()); }
 
-    ORATIOSOLVER_EXPORT bool solver::is_enum(const riddle::expr &xpr) const { return dynamic_cast<enum_item *>(xpr.operator->()); }
+    ORATIOSOLVER_EXPORT bool solver::is_enum(const riddle::expr &xpr) const { return get_kind(*xpr) == enum_kind; }
+    item_kind solver::get_kind(const riddle::item &itm) const noexcept
+    {
+        if (itm.get_type().is_primitive()) // primitive items are always built by the solver, hence they carry their kind..
+            return static_cast<const primitive_item &>(itm).get_kind();
+        else if (dynamic_cast<const enum_item *>(&itm)) // enums are never created for primitive types..
+            return enum_kind;
+        else
+            return complex_kind;
+    }
+    utils::enum_val *solver::get_enum_val(riddle::item &itm) const noexcept
+    {
+        switch (get_kind(itm))
+        {
+        case string_kind: // strings are values of enums of strings..
+            return &static_cast<string_item &>(itm);
+        case complex_kind: // complex items (including atoms) are values of enums of their type..
+            return &static_cast<riddle::complex_item &>(itm);
+        default:
+            return nullptr;
+        }
+    }
     ORATIOSOLVER_EXPORT std::vector<riddle::expr> solver::domain(const riddle::expr &xpr) const
     {
         assert(is_enum(xpr));
@@ -661,7 +777,7 @@ namespace ratio
     void solver::prune(const riddle::expr &xpr, const riddle::expr &val)
     {
         assert(is_enum(xpr));
-        auto alw_var = ov_th.allows(static_cast<ratio::enum_item &>(*xpr).get_var(), dynamic_cast<utils::enum_val &>(*val));
+        auto alw_var = ov_th.allows(static_cast<ratio::enum_item &>(*xpr).get_var(), *get_enum_val(*val));
         if (!sat->new_clause({!ni, alw_var}))
             throw riddle::unsolvable_exception(); // the problem is unsolvable..
     }
@@ -674,7 +790,7 @@ namespace ratio
         {
             if (sat->root_level())
             { // we make sure that gamma is at true..
-                gr->build();
+                gr->grow();
                 gr->check();
             }
             assert(sat->value(gr->gamma) == utils::True);
@@ -692,25 +808,29 @@ namespace ratio
                                    { return std::none_of(f->resolvers.cbegin(), f->resolvers.cend(), [this](const auto &r)
                                                          { return sat->value(r.get().rho) == utils::True; }); })); // none of the current flaws must have already been solved..
 
-                // this is the next flaw (i.e. the most expensive one) to be solved..
-                auto &best_flaw = **std::min_element(active_flaws.cbegin(), active_flaws.cend(), [](const auto &f0, const auto &f1)
-                                                     { return f0->get_estimated_cost() > f1->get_estimated_cost(); });
+                // this is the next flaw (i.e. the most expensive one, by default) to be solved..
+                auto &best_flaw = gr->select_flaw();
                 FIRE_CURRENT_FLAW(best_flaw);
 
                 if (is_infinite(best_flaw.get_estimated_cost()))
                 { // we don't know how to solve this flaw :(
+#ifdef LAZY_GRAPH
+                    if (!expand_lazily(best_flaw)) // we have nothing left to expand, hence we have to search..
+                        next();
+#else
                     do
                     { // we have to search..
                         next();
                     } while (std::any_of(active_flaws.cbegin(), active_flaws.cend(), [](const auto &f)
                                          { return is_infinite(f->get_estimated_cost()); }));
+#endif
                     // we solve all the current inconsistencies..
                     solve_inconsistencies();
                     continue;
                 }
 
-                // this is the next resolver (i.e. the cheapest one) to be applied..
-                auto &best_res = best_flaw.get_best_resolver();
+                // this is the next resolver (i.e. the cheapest one, by default) to be applied..
+                auto &best_res = gr->select_resolver(best_flaw);
                 FIRE_CURRENT_RESOLVER(best_res);
 
                 assert(!is_infinite(best_res.get_estimated_cost()));
@@ -732,23 +852,27 @@ namespace ratio
                                        { return std::none_of(f->resolvers.cbegin(), f->resolvers.cend(), [this](const auto &r)
                                                              { return sat->value(r.get().rho) == utils::True; }); })); // none of the current flaws must have already been solved..
 
-                    // this is the next flaw (i.e. the most expensive one) to be solved..
-                    auto &best_flaw = **std::min_element(active_flaws.cbegin(), active_flaws.cend(), [](const auto f0, const auto f1)
-                                                         { return f0->get_estimated_cost() > f1->get_estimated_cost(); });
+                    // this is the next flaw (i.e. the most expensive one, by default) to be solved..
+                    auto &best_flaw = gr->select_flaw();
                     FIRE_CURRENT_FLAW(best_flaw);
 
                     if (is_infinite(best_flaw.get_estimated_cost()))
                     { // we don't know how to solve this flaw :(
+#ifdef LAZY_GRAPH
+                        if (!expand_lazily(best_flaw)) // we have nothing left to expand, hence we have to search..
+                            next();
+#else
                         do
                         { // we have to search..
                             next();
                         } while (std::any_of(active_flaws.cbegin(), active_flaws.cend(), [](const auto f)
                                              { return is_infinite(f->get_estimated_cost()); }));
+#endif
                         continue;
                     }
 
-                    // this is the next resolver (i.e. the cheapest one) to be applied..
-                    auto &best_res = best_flaw.get_best_resolver();
+                    // this is the next resolver (i.e. the cheapest one, by default) to be applied..
+                    auto &best_res = gr->select_resolver(best_flaw);
                     FIRE_CURRENT_RESOLVER(best_res);
 
                     assert(!is_infinite(best_res.get_estimated_cost()));
@@ -788,11 +912,11 @@ namespace ratio
 
         assert(std::all_of(phis.cbegin(), phis.cend(), [this](const auto &v_fs)
                            { return std::all_of(
-                  v_fs.second.cbegin(), v_fs.second.cend(), [this](const auto &f)
-                  { return (sat->value(f->phi) != utils::False && f->get_estimated_cost() == (f->get_resolvers().empty() ? utils::rational::POSITIVE_INFINITY : f->get_best_resolver().get_estimated_cost())) || is_positive_infinite(f->get_estimated_cost()); }); }));
+                  v_fs.cbegin(), v_fs.cend(), [this](const auto &f)
+                  { return (sat->value(f->phi) != utils::False && f->get_estimated_cost() == (f->get_resolvers().empty() ? positive_infinite_cost() : f->get_best_resolver().get_estimated_cost())) || is_positive_infinite(f->get_estimated_cost()); }); }));
         assert(std::all_of(rhos.cbegin(), rhos.cend(), [this](const auto &v_rs)
                            { return std::all_of(
-                  v_rs.second.cbegin(), v_rs.second.cend(), [this](const auto &r)
+                  v_rs.cbegin(), v_rs.cend(), [this](const auto &r)
                   { return is_positive_infinite(r->get_estimated_cost()) || sat->value(r->rho) != utils::False; }); }));
 
         FIRE_STATE_CHANGED();
@@ -812,11 +936,11 @@ namespace ratio
 
         assert(std::all_of(phis.cbegin(), phis.cend(), [this](const auto &v_fs)
                            { return std::all_of(
-                  v_fs.second.cbegin(), v_fs.second.cend(), [this](const auto &f)
-                  { return (sat->value(f->phi) != utils::False && f->get_estimated_cost() == (f->get_resolvers().empty() ? utils::rational::POSITIVE_INFINITY : f->get_best_resolver().get_estimated_cost())) || is_positive_infinite(f->get_estimated_cost()); }); }));
+                  v_fs.cbegin(), v_fs.cend(), [this](const auto &f)
+                  { return (sat->value(f->phi) != utils::False && f->get_estimated_cost() == (f->get_resolvers().empty() ? positive_infinite_cost() : f->get_best_resolver().get_estimated_cost())) || is_positive_infinite(f->get_estimated_cost()); }); }));
         assert(std::all_of(rhos.cbegin(), rhos.cend(), [this](const auto &v_rs)
                            { return std::all_of(
-                  v_rs.second.cbegin(), v_rs.second.cend(), [this](const auto &r)
+                  v_rs.cbegin(), v_rs.cend(), [this](const auto &r)
                   { return is_positive_infinite(r->get_estimated_cost()) || sat->value(r->rho) != utils::False; }); }));
 
         FIRE_STATE_CHANGED();
@@ -855,7 +979,10 @@ namespace ratio
             break;
         }
 
-        phis[variable(f->phi)].emplace_back(std::move(f));
+        const auto phi_var = variable(f->phi);
+        if (phis.size() <= phi_var)
+            phis.resize(phi_var + 1);
+        phis[phi_var].emplace_back(std::move(f));
     }
 
     void solver::new_resolver(resolver_ptr r)
@@ -863,8 +990,13 @@ namespace ratio
         FIRE_NEW_RESOLVER(*r);
         if (sat->value(r->rho) == utils::Undefined) // we do not have a top-level (a landmark) resolver, nor an infeasible one..
             bind(variable(r->rho));                 // we listen for the resolver to become inactive..
+        else if (sat->value(r->rho) == utils::False) // the resolver has been negated before we could listen for it..
+            update_cost(*r);
 
-        rhos[variable(r->rho)].push_back(std::move(r));
+        const auto rho_var = variable(r->rho);
+        if (rhos.size() <= rho_var)
+            rhos.resize(rho_var + 1);
+        rhos[rho_var].push_back(std::move(r));
     }
 
     void solver::new_causal_link(flaw &f, resolver &r)
@@ -872,13 +1004,41 @@ namespace ratio
         FIRE_CAUSAL_LINK_ADDED(f, r);
         r.preconditions.push_back(f);
         f.supports.push_back(r);
+        update_cost(r); // the cost of the resolver now depends on the flaw..
         // activating the resolver requires the activation of the flaw..
         [[maybe_unused]] bool new_clause = sat->new_clause({!r.rho, f.phi});
         assert(new_clause);
         // we introduce an ordering constraint..
+#ifdef TOPOLOGICAL_ORDERING
+        if (sat->value(r.rho) == utils::True && !add_causal_edge(f, r))
+        { // the resolver has already been activated, hence the causal link must be consistent with the activated ones..
+            assert(sat->root_level());
+            cnfl.clear();
+            throw riddle::unsolvable_exception();
+        }
+#else
         [[maybe_unused]] bool new_dist = sat->new_clause({!r.rho, idl_th.new_distance(r.get_flaw().position, f.position, 0)});
         assert(new_dist);
+#endif
+    }
+
+#ifdef TOPOLOGICAL_ORDERING
+    bool solver::add_causal_edge(flaw &f, resolver &r)
+    {
+        // notice that, unlike the (non-strict) distance constraint of the integer difference logic ordering, the edge places the flaw strictly before the resolver's effect, hence causal cycles are rejected even if all their flaws could share the same position (a flaw is never a precondition of its own resolvers, so no acyclic support is lost)..
+        std::vector<resolver *> cycle;
+        if (!t_ord.add_edge(f.position, r.f.position, &r, cycle))
+        { // we have a causal cycle, which cannot be activated as a whole..
+            cnfl.push_back(!r.rho);
+            for (const auto &c_r : cycle)
+                cnfl.push_back(!c_r->rho);
+            return false;
+        }
+        if (!trail.empty()) // we store the causal edge for allowing backtracking..
+            causal_edges.emplace_back(&f, &r);
+        return true;
     }
+#endif
 
     void solver::expand_flaw(flaw &f)
     {
@@ -887,6 +1047,10 @@ namespace ratio
         // we expand the flaw..
         f.expand();
 
+        // the costs of the resolvers supported by the flaw might now be finite..
+        for (const auto &r : f.supports)
+            update_cost(r);
+
         // we apply the flaw's resolvers..
         for (const auto &r : f.resolvers)
             apply_resolver(r);
@@ -920,17 +1084,91 @@ namespace ratio
         res = nullptr;
     }
 
-    void solver::set_cost(flaw &f, utils::rational cost)
+    void solver::set_cost(flaw &f, cost_t cost)
     {
         assert(f.est_cost != cost);
-        if (!trail.empty()) // we store the current flaw's estimated cost, if not already stored, for allowing backtracking..
-            trail.back().old_f_costs.try_emplace(&f, f.est_cost);
+        if (!trail.empty()) // we store the current flaw's estimated cost for allowing backtracking..
+            old_f_costs.emplace_back(&f, f.est_cost);
 
         // we update the flaw's estimated cost..
         f.est_cost = cost;
         FIRE_FLAW_COST_CHANGED(f);
+
+        // we update the estimated costs of the resolvers supported by the flaw..
+        for (const auto &r : f.supports)
+            update_cost(r);
     }
 
+    void solver::update_cost(resolver &r)
+    {
+        auto cost = r.compute_estimated_cost();
+        if (r.est_cost == cost)
+            return; // nothing to update..
+        if (!trail.empty()) // we store the current resolver's estimated cost for allowing backtracking..
+            old_r_costs.emplace_back(&r, r.est_cost);
+
+        // we update the resolver's estimated cost..
+        const bool increased = r.est_cost < cost;
+        r.est_cost = std::move(cost);
+
+        // we update the cheapest resolver of the resolver's flaw..
+        auto &f = r.f;
+        if (f.cheapest == &r)
+        { // if the cheapest resolver got more expensive, some other resolver might be cheaper..
+            if (increased)
+                set_cheapest(f, *std::min_element(f.resolvers.cbegin(), f.resolvers.cend(), [](const auto &r0, const auto &r1)
+                                                  { return r0.get().est_cost < r1.get().est_cost; }));
+        }
+        else if (f.cheapest && r.est_cost < f.cheapest->est_cost)
+            set_cheapest(f, r);
+    }
+
+    void solver::set_cheapest(flaw &f, resolver &r)
+    {
+        if (f.cheapest == &r)
+            return; // nothing to update..
+        if (!trail.empty()) // we store the current flaw's cheapest resolver for allowing backtracking..
+            old_cheapests.emplace_back(&f, f.cheapest);
+        f.cheapest = &r;
+    }
+
+#ifdef LAZY_GRAPH
+    bool solver::expand_lazily(flaw &f)
+    {
+        if (gr->is_exhausted() || !gr->is_expandable(f))
+            return false; // the causal subgraph supporting the flaw has already been fully expanded (or the graph cannot be further expanded)..
+
+        // introducing new flaws requires being at root-level, hence we backtrack..
+        LOG("lazily expanding the causal graph..");
+        const auto decisions = sat->get_decisions();
+        while (!sat->root_level())
+            sat->pop();
+
+        // we expand the causal subgraph supporting the flaw..
+        try
+        {
+            gr->expand_subgraph(f);
+        }
+        catch (const budget_exceeded_exception &)
+        { // we stop expanding the graph, searching on the current one..
+            LOG("the causal graph budget has been exceeded..");
+            gr->exhausted = true;
+        }
+
+        if (!sat->propagate())
+            throw riddle::unsolvable_exception();
+        // the flaws closed by the graph pruning might have been expanded, hence we check the grown graph with a new graph variable..
+        gr->reset_gamma();
+        gr->check(); // we make sure that gamma is at true..
+
+        // we restore the previously taken decisions, as long as they are consistent with the expanded graph (a conflict might backjump to root-level, hence we go through `take_decision`)..
+        for (const auto &d : decisions)
+            if (sat->value(d) == utils::Undefined)
+                take_decision(d);
+        return true;
+    }
+#endif
+
     void solver::solve_inconsistencies()
     {
         // all the current inconsistencies..
@@ -1042,27 +1280,24 @@ namespace ratio
     bool solver::propagate(const semitone::lit &p)
     {
         assert(cnfl.empty());
-        assert(phis.count(variable(p)) || rhos.count(variable(p)));
-
-        const auto at_phis_p = phis.find(variable(p));
-        const auto at_rhos_p = rhos.find(variable(p));
-        assert(at_phis_p != phis.cend() || at_rhos_p != rhos.cend());
+        const auto p_var = variable(p);
+        assert((p_var < phis.size() && !phis[p_var].empty()) || (p_var < rhos.size() && !rhos[p_var].empty()));
 
         // we check the flaws..
-        if (at_phis_p != phis.cend())
-            for (const auto &f : at_phis_p->second)
+        if (p_var < phis.size())
+            for (const auto &f : phis[p_var])
             { // we check the `f` flaw..
                 if (sign(p) == sign(f->phi))
                 { // the `f` flaw has been activated..
                     assert(sat->value(f->phi) == utils::True);
                     assert(!active_flaws.count(f.operator->()));
                     if (!sat->root_level())
-                        trail.back().new_flaws.insert(f.operator->());
+                        new_flaws.push_back(f.operator->());
                     if (std::none_of(f->resolvers.cbegin(), f->resolvers.cend(), [this](const auto &r)
                                      { return sat->value(r.get().rho) == utils::True; }))
                         active_flaws.insert(f.operator->()); // the `f` flaw has been activated and not yet accidentally solved..
                     else if (!sat->root_level())
-                        trail.back().solved_flaws.insert(f.operator->()); // the `f` flaw has been accidentally solved..
+                        solved_flaws.push_back(f.operator->()); // the `f` flaw has been accidentally solved..
                     gr->activated_flaw(*f);
                 }
                 else
@@ -1074,19 +1309,28 @@ namespace ratio
             }
 
         // we check the resolvers..
-        if (at_rhos_p != rhos.cend())
-            for (const auto &r : at_rhos_p->second)
+        if (p_var < rhos.size())
+            for (const auto &r : rhos[p_var])
             { // we check the `r` resolver..
                 if (sign(p) == sign(r->rho))
                 { // the `r` resolver has been activated..
                     assert(sat->value(r->rho) == utils::True);
                     if (active_flaws.erase(&r->f) && !sat->root_level()) // since the resolver has been activated, its effect flaw has been resolved (notice that we remove its effect only in case it was already active)..
-                        trail.back().solved_flaws.insert(&r->f);
+                        solved_flaws.push_back(&r->f);
+#ifdef TOPOLOGICAL_ORDERING
+                    // we add the causal links of the resolver (i.e., the preconditions which are not caused by it) to the topological order..
+                    for (const auto &p : r->preconditions)
+                        if (std::none_of(p.get().causes.cbegin(), p.get().causes.cend(), [&r](const auto &c)
+                                         { return &c.get() == r.operator->(); }) &&
+                            !add_causal_edge(p, *r))
+                            return false;
+#endif
                     gr->activated_resolver(*r);
                 }
                 else
                 { // the `r` resolver has been negated..
                     assert(sat->value(r->rho) == utils::False);
+                    update_cost(*r); // the resolver is now infinitely expensive..
                     gr->negated_resolver(*r);
                 }
             }
@@ -1101,12 +1345,16 @@ namespace ratio
                            { return sat->value(f->phi) == utils::True; }));
         assert(std::all_of(phis.cbegin(), phis.cend(), [this](const auto &v_fs)
                            { return std::all_of(
-                  v_fs.second.cbegin(), v_fs.second.cend(), [this](const auto &f)
+                  v_fs.cbegin(), v_fs.cend(), [this](const auto &f)
                   { return sat->value(f->phi) != utils::False || is_positive_infinite(f->get_estimated_cost()); }); }));
         assert(std::all_of(rhos.cbegin(), rhos.cend(), [this](const auto &v_rs)
                            { return std::all_of(
-                  v_rs.second.cbegin(), v_rs.second.cend(), [this](const auto &r)
+                  v_rs.cbegin(), v_rs.cend(), [this](const auto &r)
                   { return sat->value(r->rho) != utils::False || is_positive_infinite(r->get_estimated_cost()); }); }));
+        assert(std::all_of(rhos.cbegin(), rhos.cend(), [](const auto &v_rs)
+                           { return std::all_of(
+                  v_rs.cbegin(), v_rs.cend(), [](const auto &r)
+                  { return r->get_estimated_cost() == r->compute_estimated_cost(); }); }));
         return true;
     }
 
@@ -1114,29 +1362,52 @@ namespace ratio
     {
         LOG(std::to_string(trail.size()) << " (" << std::to_string(active_flaws.size()) << ")");
 
-        trail.emplace_back(); // we add a new layer to the trail..
-        gr->push();           // we push the graph..
+#ifdef TOPOLOGICAL_ORDERING
+        trail.push_back({old_f_costs.size(), old_r_costs.size(), old_cheapests.size(), new_flaws.size(), solved_flaws.size(), causal_edges.size()}); // we add a new layer to the trail..
+#else
+        trail.push_back({old_f_costs.size(), old_r_costs.size(), old_cheapests.size(), new_flaws.size(), solved_flaws.size()}); // we add a new layer to the trail..
+#endif
+        gr->push(); // we push the graph..
     }
 
     void solver::pop()
     {
         LOG(std::to_string(trail.size()) << " (" << std::to_string(active_flaws.size()) << ")");
 
+        const auto &l = trail.back();
+
         // we reintroduce the solved flaw..
-        for (const auto &f : trail.back().solved_flaws)
-            active_flaws.insert(f);
+        for (auto f_it = solved_flaws.cbegin() + l.solved_flaws; f_it != solved_flaws.cend(); ++f_it)
+            active_flaws.insert(*f_it);
+        solved_flaws.resize(l.solved_flaws);
 
         // we erase the new flaws..
-        for (const auto &f : trail.back().new_flaws)
-            active_flaws.erase(f);
+        for (auto f_it = new_flaws.cbegin() + l.new_flaws; f_it != new_flaws.cend(); ++f_it)
+            active_flaws.erase(*f_it);
+        new_flaws.resize(l.new_flaws);
 
-        // we restore the flaws' estimated costs..
-        for (const auto &[f, cost] : trail.back().old_f_costs)
+        // we restore the flaws' estimated costs, in reverse order, so that each flaw gets back the cost it had before the layer was created..
+        for (auto c_it = old_f_costs.crbegin(); c_it != old_f_costs.crend() - l.old_f_costs; ++c_it)
         {
-            // assert(f.first->est_cost != cost);
-            f->est_cost = cost;
-            FIRE_FLAW_COST_CHANGED(*f);
+            c_it->first->est_cost = c_it->second;
+            FIRE_FLAW_COST_CHANGED(*c_it->first);
         }
+        old_f_costs.erase(old_f_costs.cbegin() + l.old_f_costs, old_f_costs.cend());
+
+        // we restore the resolvers' estimated costs and the flaws' cheapest resolvers, in reverse order..
+        for (auto c_it = old_r_costs.crbegin(); c_it != old_r_costs.crend() - l.old_r_costs; ++c_it)
+            c_it->first->est_cost = c_it->second;
+        old_r_costs.erase(old_r_costs.cbegin() + l.old_r_costs, old_r_costs.cend());
+        for (auto c_it = old_cheapests.crbegin(); c_it != old_cheapests.crend() - l.old_cheapests; ++c_it)
+            c_it->first->cheapest = c_it->second;
+        old_cheapests.resize(l.old_cheapests);
+
+#ifdef TOPOLOGICAL_ORDERING
+        // we remove the causal edges from the topological order..
+        for (auto e_it = causal_edges.crbegin(); e_it != causal_edges.crend() - l.causal_edges; ++e_it)
+            t_ord.remove_edge(e_it->first->position, e_it->second->f.position, e_it->second);
+        causal_edges.resize(l.causal_edges);
+#endif
 
         trail.pop_back(); // we remove the last layer from the trail..
         gr->pop();        // we pop the graph..
@@ -1360,7 +1631,7 @@ namespace ratio
         }
         else if (itm.get_type() == slv.get_int_type() || itm.get_type() == slv.get_real_type())
         {
-            auto lin = static_cast<const arith_item &>(itm).get_lin();
+            const auto &lin = static_cast<const arith_item &>(itm).get_lin();
             const auto [lb, ub] = slv.get_lra_theory().bounds(lin);
             const auto val = slv.get_lra_theory().value(lin);
 
@@ -1374,7 +1645,7 @@ namespace ratio
         }
         else if (itm.get_type() == slv.get_time_type())
         {
-            auto lin = static_cast<const arith_item &>(itm).get_lin();
+            const auto &lin = static_cast<const arith_item &>(itm).get_lin();
             const auto [lb, ub] = slv.get_rdl_theory().bounds(lin);
 
             json::json j_val = to_json(lb);
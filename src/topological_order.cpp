@@ -0,0 +1,138 @@
+#include "topological_order.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <cassert>
+
+namespace ratio
+{
+    ORATIOSOLVER_EXPORT size_t topological_order::new_node()
+    {
+        const size_t n = ord.size();
+        out_edges.emplace_back();
+        in_edges.emplace_back();
+        ord.push_back(nodes.size());
+        nodes.push_back(n);
+        return n;
+    }
+
+    ORATIOSOLVER_EXPORT bool topological_order::add_edge(const size_t &from, const size_t &to, resolver *r, std::vector<resolver *> &cycle)
+    {
+        if (from == to)
+        { // a self loop is a cycle on its own..
+            cycle.clear();
+            return false;
+        }
+
+        const auto lb = ord[to], ub = ord[from];
+        if (lb < ub)
+        { // the edge disagrees with the current order, hence we have to reorder the nodes within the affected region..
+            // we collect the nodes reachable from the `to` node which precede the `from` node, checking for cycles..
+            std::vector<size_t> delta_f;
+            std::unordered_map<size_t, std::pair<size_t, resolver *>> f_parents{{to, {to, nullptr}}}; // the visited nodes, with the edges they have been reached through..
+            std::vector<size_t> q{to};
+            while (!q.empty())
+            {
+                const auto n = q.back();
+                q.pop_back();
+                delta_f.push_back(n);
+                for (const auto &[m, l] : out_edges[n])
+                    if (m == from)
+                    { // we have found a cycle, hence we collect the labels of its edges..
+                        cycle.clear();
+                        if (l)
+                            cycle.push_back(l);
+                        for (auto c_n = n; c_n != to; c_n = f_parents.at(c_n).first)
+                            if (const auto &c_l = f_parents.at(c_n).second)
+                                cycle.push_back(c_l);
+                        return false;
+                    }
+                    else if (ord[m] < ub && f_parents.emplace(m, std::make_pair(n, l)).second)
+                        q.push_back(m);
+            }
+
+            // we collect the nodes reaching the `from` node which follow the `to` node..
+            std::vector<size_t> delta_b;
+            std::unordered_set<size_t> b_visited{from};
+            q.push_back(from);
+            while (!q.empty())
+            {
+                const auto n = q.back();
+                q.pop_back();
+                delta_b.push_back(n);
+                for (const auto &[m, l] : in_edges[n])
+                    if (ord[m] > lb && b_visited.insert(m).second)
+                        q.push_back(m);
+            }
+
+            // we move the nodes reaching the `from` node before the nodes reachable from the `to` node, reusing their positions..
+            const auto cmp = [this](const size_t &n0, const size_t &n1)
+            { return ord[n0] < ord[n1]; };
+            std::sort(delta_b.begin(), delta_b.end(), cmp);
+            std::sort(delta_f.begin(), delta_f.end(), cmp);
+            std::vector<size_t> positions;
+            positions.reserve(delta_b.size() + delta_f.size());
+            for (const auto &n : delta_b)
+                positions.push_back(ord[n]);
+            for (const auto &n : delta_f)
+                positions.push_back(ord[n]);
+            std::sort(positions.begin(), positions.end());
+            size_t i = 0;
+            for (const auto &n : delta_b)
+            {
+                ord[n] = positions[i];
+                nodes[positions[i++]] = n;
+            }
+            for (const auto &n : delta_f)
+            {
+                ord[n] = positions[i];
+                nodes[positions[i++]] = n;
+            }
+        }
+        assert(ord[from] < ord[to]);
+
+        out_edges[from].emplace_back(to, r);
+        in_edges[to].emplace_back(from, r);
+        return true;
+    }
+
+    ORATIOSOLVER_EXPORT void topological_order::remove_edge(const size_t &from, const size_t &to, const resolver *r)
+    {
+        auto &c_out = out_edges[from];
+        const auto out_it = std::find_if(c_out.begin(), c_out.end(), [&to, &r](const auto &e)
+                                         { return e.first == to && e.second == r; });
+        assert(out_it != c_out.end());
+        *out_it = c_out.back();
+        c_out.pop_back();
+
+        auto &c_in = in_edges[to];
+        const auto in_it = std::find_if(c_in.begin(), c_in.end(), [&from, &r](const auto &e)
+                                        { return e.first == from && e.second == r; });
+        assert(in_it != c_in.end());
+        *in_it = c_in.back();
+        c_in.pop_back();
+    }
+
+    ORATIOSOLVER_EXPORT bool topological_order::reaches(const size_t &from, const size_t &to) const
+    {
+        if (from == to)
+            return true;
+        if (ord[to] < ord[from])
+            return false; // the order guarantees that the `to` node is not reachable from the `from` node..
+
+        // we visit the nodes reachable from the `from` node which do not follow the `to` node..
+        std::unordered_set<size_t> visited{from};
+        std::vector<size_t> q{from};
+        while (!q.empty())
+        {
+            const auto n = q.back();
+            q.pop_back();
+            for (const auto &e : out_edges[n])
+                if (e.first == to)
+                    return true;
+                else if (ord[e.first] < ord[to] && visited.insert(e.first).second)
+                    q.push_back(e.first);
+        }
+        return false;
+    }
+} // namespace ratio
@@ -60,19 +60,19 @@ namespace ratio
     {
         std::vector<std::vector<std::pair<semitone::lit, double>>> incs;
         // we partition atoms for each consumable-resource they might insist on..
-        std::unordered_map<const riddle::complex_item *, std::vector<atom *>> cr_instances;
-        for (const auto &atm : atoms)
-            if (get_solver().get_sat_core().value(atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
+        std::unordered_map<const riddle::complex_item *, std::vector<const atom_record *>> cr_instances;
+        for (const auto &a_rec : atoms)
+            if (get_solver().get_sat_core().value(a_rec.atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
             {
-                const auto cr = atm->get(TAU_KW); // we get the consumable-resource..
-                if (auto enum_scope = dynamic_cast<enum_item *>(cr.operator->()))
+                const auto &cr = a_rec.tau; // we get the consumable-resource..
+                if (const auto enum_scope = a_rec.tau_enum)
                 { // the `tau` parameter is a variable..
                     for (const auto &cr_val : get_solver().get_ov_theory().value(enum_scope->get_var()))
                         if (to_check.count(static_cast<const riddle::complex_item *>(cr_val))) // we consider only those consumable-resources which are still to be checked..
-                            cr_instances[static_cast<const riddle::complex_item *>(cr_val)].emplace_back(atm);
+                            cr_instances[static_cast<const riddle::complex_item *>(cr_val)].emplace_back(&a_rec);
                 }
                 else if (to_check.count(static_cast<riddle::complex_item *>(cr.operator->()))) // we consider only those consumable-resources which are still to be checked..
-                    cr_instances[static_cast<riddle::complex_item *>(cr.operator->())].emplace_back(atm);
+                    cr_instances[static_cast<riddle::complex_item *>(cr.operator->())].emplace_back(&a_rec);
             }
 
         return incs;
@@ -97,25 +97,25 @@ namespace ratio
         const auto start = atm.get(RATIO_START);
         const auto end = atm.get(RATIO_END);
 
-        for (const auto &c_atm : atoms)
+        for (const auto &c_rec : atoms)
         {
-            const auto c_start = c_atm->get(RATIO_START);
-            const auto c_end = c_atm->get(RATIO_END);
+            const auto &c_start = c_rec.start;
+            const auto &c_end = c_rec.end;
 
 #ifdef DL_TN
-            auto atm_before = get_solver().get_rdl_theory().new_leq(static_cast<arith_item &>(*end).get_lin(), static_cast<arith_item &>(*c_start).get_lin());
-            auto atm_after = get_solver().get_rdl_theory().new_leq(static_cast<arith_item &>(*c_end).get_lin(), static_cast<arith_item &>(*start).get_lin());
+            auto atm_before = get_solver().new_leq(end, c_start, true);
+            auto atm_after = get_solver().new_leq(c_end, start, true);
 #elif LA_TN
-            auto atm_before = get_solver().get_lra_theory().new_leq(static_cast<arith_item &>(*end).get_lin(), static_cast<arith_item &>(*c_start).get_lin());
-            auto atm_after = get_solver().get_lra_theory().new_leq(static_cast<arith_item &>(*c_end).get_lin(), static_cast<arith_item &>(*start).get_lin());
+            auto atm_before = get_solver().new_leq(end, c_start, false);
+            auto atm_after = get_solver().new_leq(c_end, start, false);
             // we boost propagation..
             [[maybe_unused]] bool nc = get_solver().get_sat_core().new_clause({!atm_before, !atm_after});
             assert(nc);
 #endif
             if (get_solver().get_sat_core().value(atm_before) == utils::Undefined)
-                leqs[&atm][c_atm] = atm_before;
+                leqs[&atm][c_rec.atm] = atm_before;
             if (get_solver().get_sat_core().value(atm_after) == utils::Undefined)
-                leqs[c_atm][&atm] = atm_after;
+                leqs[c_rec.atm][&atm] = atm_after;
         }
 
         const auto tau = atm.get(TAU_KW);
@@ -131,19 +131,18 @@ namespace ratio
                 }
         }
 
-        atoms.emplace_back(&atm);
+        atoms.emplace_back(atm, start, end, tau, atm.get(CONSUMABLE_RESOURCE_AMOUNT_NAME));
         // we store, for the atom, its atom listener..
         listeners.emplace_back(new cr_atom_listener(*this, atm));
 
         // we filter out those atoms which are not strictly active..
         if (get_solver().get_sat_core().value(atm.get_sigma()) == utils::True)
         {
-            const auto c_scope = atm.get(TAU_KW);
-            if (const auto enum_scope = dynamic_cast<enum_item *>(c_scope.operator->()))          // the `tau` parameter is a variable..
-                for (const auto &val : get_solver().get_ov_theory().value(enum_scope->get_var())) // we check for all its allowed values..
+            if (const auto tau_enum = dynamic_cast<enum_item *>(tau.operator->()))             // the `tau` parameter is a variable..
+                for (const auto &val : get_solver().get_ov_theory().value(tau_enum->get_var())) // we check for all its allowed values..
                     to_check.insert(dynamic_cast<const riddle::item *>(val));
             else // the `tau` parameter is a constant..
-                to_check.insert(&*c_scope);
+                to_check.insert(&*tau);
         }
     }
 
@@ -203,19 +202,19 @@ namespace ratio
     {
         json::json tls(json::json_type::array);
         // we partition atoms for each consumable-resource they might insist on..
-        std::unordered_map<riddle::complex_item *, std::vector<atom *>> cr_instances;
-        for (const auto &atm : atoms)
-            if (get_solver().get_sat_core().value(atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
+        std::unordered_map<riddle::complex_item *, std::vector<const atom_record *>> cr_instances;
+        for (const auto &a_rec : atoms)
+            if (get_solver().get_sat_core().value(a_rec.atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
             {
-                const auto cr = atm->get(TAU_KW); // we get the consumable-resource..
-                if (auto enum_scope = dynamic_cast<enum_item *>(cr.operator->()))
+                const auto &cr = a_rec.tau; // we get the consumable-resource..
+                if (const auto enum_scope = a_rec.tau_enum)
                 { // the `tau` parameter is a variable..
                     for (const auto &cr_val : get_solver().get_ov_theory().value(enum_scope->get_var()))
                         if (to_check.count(static_cast<riddle::complex_item *>(cr_val))) // we consider only those consumable-resources which are still to be checked..
-                            cr_instances[static_cast<riddle::complex_item *>(cr_val)].emplace_back(atm);
+                            cr_instances[static_cast<riddle::complex_item *>(cr_val)].emplace_back(&a_rec);
                 }
                 else if (to_check.count(static_cast<riddle::complex_item *>(cr.operator->()))) // we consider only those consumable-resources which are still to be checked..
-                    cr_instances[static_cast<riddle::complex_item *>(cr.operator->())].emplace_back(atm);
+                    cr_instances[static_cast<riddle::complex_item *>(cr.operator->())].emplace_back(&a_rec);
             }
 
         for (const auto &[cres, atms] : cr_instances)
@@ -227,16 +226,16 @@ namespace ratio
 #endif
 
             // for each pulse, the atoms starting at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> starting_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> starting_atoms;
             // for each pulse, the atoms ending at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> ending_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> ending_atoms;
             // all the pulses of the timeline..
             std::set<utils::inf_rational> pulses;
 
             for (const auto &atm : atms)
             {
-                const auto start = get_solver().arith_value(atm->get(RATIO_START));
-                const auto end = get_solver().arith_value(atm->get(RATIO_END));
+                const auto start = get_solver().arith_value(atm->start);
+                const auto end = get_solver().arith_value(atm->end);
                 starting_atoms[start].insert(atm);
                 ending_atoms[end].insert(atm);
                 pulses.insert(start);
@@ -245,7 +244,7 @@ namespace ratio
             pulses.insert(get_solver().arith_value(get_solver().get("origin")));
             pulses.insert(get_solver().arith_value(get_solver().get("horizon")));
 
-            std::set<atom *> overlapping_atoms;
+            std::set<const atom_record *> overlapping_atoms;
             std::set<utils::inf_rational>::iterator p = pulses.begin();
             if (const auto at_start_p = starting_atoms.find(*p); at_start_p != starting_atoms.cend())
                 overlapping_atoms.insert(at_start_p->second.cbegin(), at_start_p->second.cend());
@@ -263,10 +262,10 @@ namespace ratio
                 utils::inf_rational c_angular_coefficient; // the concurrent resource update..
                 for (const auto &atm : overlapping_atoms)
                 {
-                    auto c_coeff = get_produce_predicate().is_assignable_from(atm->get_type()) ? get_solver().arith_value(atm->get(CONSUMABLE_RESOURCE_AMOUNT_NAME)) : -get_solver().arith_value(atm->get(CONSUMABLE_RESOURCE_AMOUNT_NAME));
-                    c_coeff /= (get_solver().arith_value(atm->get(RATIO_END)) - get_solver().arith_value(atm->get(RATIO_START))).get_rational();
+                    auto c_coeff = get_produce_predicate().is_assignable_from(atm->atm->get_type()) ? get_solver().arith_value(atm->amount) : -get_solver().arith_value(atm->amount);
+                    c_coeff /= (get_solver().arith_value(atm->end) - get_solver().arith_value(atm->start)).get_rational();
                     c_angular_coefficient += c_coeff;
-                    j_atms.push_back(get_id(*atm));
+                    j_atms.push_back(get_id(*atm->atm));
                 }
                 j_val["atoms"] = std::move(j_atms);
                 j_val["start"] = to_json(c_val);
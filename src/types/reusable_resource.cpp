@@ -44,28 +44,28 @@ namespace ratio
     {
         std::vector<std::vector<std::pair<semitone::lit, double>>> incs;
         // we partition atoms for each reusable-resource they might insist on..
-        std::unordered_map<riddle::complex_item *, std::vector<atom *>> rr_instances;
-        for (const auto &atm : atoms)
-            if (get_solver().get_sat_core().value(atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
+        std::unordered_map<riddle::complex_item *, std::vector<const atom_record *>> rr_instances;
+        for (const auto &a_rec : atoms)
+            if (get_solver().get_sat_core().value(a_rec.atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
             {
-                const auto rr = atm->get(TAU_KW); // we get the reusable-resource..
-                if (auto enum_scope = dynamic_cast<enum_item *>(rr.operator->()))
+                const auto &rr = a_rec.tau; // we get the reusable-resource..
+                if (const auto enum_scope = a_rec.tau_enum)
                 { // the `tau` parameter is a variable..
                     for (const auto &rr_val : get_solver().get_ov_theory().value(enum_scope->get_var()))
                         if (to_check.count(static_cast<riddle::complex_item *>(rr_val))) // we consider only those reusable-resources which are still to be checked..
-                            rr_instances[static_cast<riddle::complex_item *>(rr_val)].emplace_back(atm);
+                            rr_instances[static_cast<riddle::complex_item *>(rr_val)].emplace_back(&a_rec);
                 }
                 else if (to_check.count(static_cast<riddle::complex_item *>(rr.operator->()))) // we consider only those reusable-resources which are still to be checked..
-                    rr_instances[static_cast<riddle::complex_item *>(rr.operator->())].emplace_back(atm);
+                    rr_instances[static_cast<riddle::complex_item *>(rr.operator->())].emplace_back(&a_rec);
             }
 
         // we detect inconsistencies for each of the reusable-resource instances..
         for (const auto &[rr, atms] : rr_instances)
         {
             // for each pulse, the atoms starting at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> starting_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> starting_atoms;
             // for each pulse, the atoms ending at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> ending_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> ending_atoms;
             // all the pulses of the timeline..
             std::set<utils::inf_rational> pulses;
             // the resource capacity..
@@ -73,8 +73,8 @@ namespace ratio
 
             for (const auto &atm : atms)
             {
-                const auto start = get_solver().arith_value(atm->get(RATIO_START));
-                const auto end = get_solver().arith_value(atm->get(RATIO_END));
+                const auto start = get_solver().arith_value(atm->start);
+                const auto end = get_solver().arith_value(atm->end);
                 starting_atoms[start].insert(atm);
                 ending_atoms[end].insert(atm);
                 pulses.insert(start);
@@ -82,7 +82,7 @@ namespace ratio
             }
 
             bool has_conflict = false;
-            std::set<atom *> overlapping_atoms;
+            std::set<const atom_record *> overlapping_atoms;
             for (const auto &p : pulses)
             {
                 if (const auto at_start_p = starting_atoms.find(p); at_start_p != starting_atoms.cend())
@@ -93,16 +93,19 @@ namespace ratio
 
                 utils::inf_rational c_usage; // the concurrent resource usage..
                 for (const auto &a : overlapping_atoms)
-                    c_usage += get_solver().arith_value(a->get(REUSABLE_RESOURCE_AMOUNT_NAME));
+                    c_usage += get_solver().arith_value(a->amount);
 
                 if (c_usage > c_capacity) // we have a 'peak'..
                 {
                     has_conflict = true;
                     // we extract minimal conflict sets (MCSs)..
                     // we sort the overlapping atoms, according to their resource usage, in descending order..
-                    std::vector<atom *> inc_atoms(overlapping_atoms.cbegin(), overlapping_atoms.cend());
-                    std::sort(inc_atoms.begin(), inc_atoms.end(), [this](const auto &atm0, const auto &atm1)
-                              { return get_solver().arith_value(atm0->get(REUSABLE_RESOURCE_AMOUNT_NAME)) > get_solver().arith_value(atm1->get(REUSABLE_RESOURCE_AMOUNT_NAME)); });
+                    std::vector<std::pair<utils::inf_rational, const atom_record *>> inc_atoms;
+                    inc_atoms.reserve(overlapping_atoms.size());
+                    for (const auto &a : overlapping_atoms)
+                        inc_atoms.emplace_back(get_solver().arith_value(a->amount), a);
+                    std::sort(inc_atoms.begin(), inc_atoms.end(), [](const auto &atm0, const auto &atm1)
+                              { return atm0.first > atm1.first; });
 
                     utils::inf_rational mcs_usage;       // the concurrent mcs resource usage..
                     auto mcs_begin = inc_atoms.cbegin(); // the beginning of the current mcs..
@@ -112,13 +115,19 @@ namespace ratio
                         // we increase the size of the current mcs..
                         while (mcs_usage <= c_capacity && mcs_end != inc_atoms.cend())
                         {
-                            mcs_usage += get_solver().arith_value((*mcs_end)->get(REUSABLE_RESOURCE_AMOUNT_NAME));
+                            mcs_usage += mcs_end->first;
                             ++mcs_end;
                         }
 
                         if (mcs_usage > c_capacity)
                         { // we have a new mcs..
-                            std::set<atom *> mcs(mcs_begin, mcs_end);
+                            std::vector<const atom_record *> mcs_atoms;
+                            std::set<atom *> mcs;
+                            for (auto it = mcs_begin; it != mcs_end; ++it)
+                            {
+                                mcs_atoms.push_back(it->second);
+                                mcs.insert(it->second->atm);
+                            }
                             if (!rr_flaws.count(mcs))
                             { // we create a new reusable-resource flaw..
                                 auto flw = new rr_flaw(*this, mcs);
@@ -128,15 +137,15 @@ namespace ratio
 
                             std::vector<std::pair<semitone::lit, double>> choices;
                             std::unordered_set<semitone::var> vars;
-                            for (const auto &as : utils::combinations(std::vector<atom *>(mcs_begin, mcs_end), 2))
+                            for (const auto &as : utils::combinations(mcs_atoms, 2))
                             {
-                                const auto a0_start = as[0]->get(RATIO_START);
-                                const auto a0_end = as[0]->get(RATIO_END);
-                                const auto a1_start = as[1]->get(RATIO_START);
-                                const auto a1_end = as[1]->get(RATIO_END);
+                                const auto &a0_start = as[0]->start;
+                                const auto &a0_end = as[0]->end;
+                                const auto &a1_start = as[1]->start;
+                                const auto &a1_end = as[1]->end;
 
-                                if (auto a0_it = leqs.find(as[0]); a0_it != leqs.cend())
-                                    if (auto a0_a1_it = a0_it->second.find(as[1]); a0_a1_it != a0_it->second.cend())
+                                if (auto a0_it = leqs.find(as[0]->atm); a0_it != leqs.cend())
+                                    if (auto a0_a1_it = a0_it->second.find(as[1]->atm); a0_a1_it != a0_it->second.cend())
                                         if (get_solver().get_sat_core().value(a0_a1_it->second) == utils::Undefined && vars.insert(variable(a0_a1_it->second)).second)
                                         {
 #ifdef DL_TN
@@ -149,8 +158,8 @@ namespace ratio
                                             choices.emplace_back(a0_a1_it->second, commit);
                                         }
 
-                                if (auto a1_it = leqs.find(as[1]); a1_it != leqs.cend())
-                                    if (auto a1_a0_it = a1_it->second.find(as[0]); a1_a0_it != a1_it->second.cend())
+                                if (auto a1_it = leqs.find(as[1]->atm); a1_it != leqs.cend())
+                                    if (auto a1_a0_it = a1_it->second.find(as[0]->atm); a1_a0_it != a1_it->second.cend())
                                         if (get_solver().get_sat_core().value(a1_a0_it->second) == utils::Undefined && vars.insert(variable(a1_a0_it->second)).second)
                                         {
 #ifdef DL_TN
@@ -174,7 +183,7 @@ namespace ratio
                                 }
 
                             // we decrease the size of the mcs..
-                            mcs_usage -= get_solver().arith_value((*mcs_begin)->get(REUSABLE_RESOURCE_AMOUNT_NAME));
+                            mcs_usage -= mcs_begin->first;
                             assert(mcs_usage <= c_capacity);
                             ++mcs_begin;
 
@@ -208,25 +217,25 @@ namespace ratio
         const auto start = atm.get(RATIO_START);
         const auto end = atm.get(RATIO_END);
 
-        for (const auto &c_atm : atoms)
+        for (const auto &c_rec : atoms)
         {
-            const auto c_start = c_atm->get(RATIO_START);
-            const auto c_end = c_atm->get(RATIO_END);
+            const auto &c_start = c_rec.start;
+            const auto &c_end = c_rec.end;
 
 #ifdef DL_TN
-            auto atm_before = get_solver().get_rdl_theory().new_leq(static_cast<arith_item &>(*end).get_lin(), static_cast<arith_item &>(*c_start).get_lin());
-            auto atm_after = get_solver().get_rdl_theory().new_leq(static_cast<arith_item &>(*c_end).get_lin(), static_cast<arith_item &>(*start).get_lin());
+            auto atm_before = get_solver().new_leq(end, c_start, true);
+            auto atm_after = get_solver().new_leq(c_end, start, true);
 #elif LA_TN
-            auto atm_before = get_solver().get_lra_theory().new_leq(static_cast<arith_item &>(*end).get_lin(), static_cast<arith_item &>(*c_start).get_lin());
-            auto atm_after = get_solver().get_lra_theory().new_leq(static_cast<arith_item &>(*c_end).get_lin(), static_cast<arith_item &>(*start).get_lin());
+            auto atm_before = get_solver().new_leq(end, c_start, false);
+            auto atm_after = get_solver().new_leq(c_end, start, false);
             // we boost propagation..
             [[maybe_unused]] bool nc = get_solver().get_sat_core().new_clause({!atm_before, !atm_after});
             assert(nc);
 #endif
             if (get_solver().get_sat_core().value(atm_before) == utils::Undefined)
-                leqs[&atm][c_atm] = atm_before;
+                leqs[&atm][c_rec.atm] = atm_before;
             if (get_solver().get_sat_core().value(atm_after) == utils::Undefined)
-                leqs[c_atm][&atm] = atm_after;
+                leqs[c_rec.atm][&atm] = atm_after;
         }
 
         const auto tau = atm.get(TAU_KW);
@@ -238,7 +247,7 @@ namespace ratio
                     frbs[&atm][dynamic_cast<riddle::item *>(rr)] = !var;
             }
 
-        atoms.emplace_back(&atm);
+        atoms.emplace_back(atm, start, end, tau, atm.get(REUSABLE_RESOURCE_AMOUNT_NAME));
         // we store, for the atom, its atom listener..
         listeners.emplace_back(new rr_atom_listener(*this, atm));
 
@@ -314,21 +323,21 @@ namespace ratio
     {
         json::json tls(json::json_type::array);
         // we partition atoms for each reusable-resource they might insist on..
-        std::unordered_map<riddle::complex_item *, std::vector<atom *>> rr_instances;
+        std::unordered_map<riddle::complex_item *, std::vector<const atom_record *>> rr_instances;
         for (const auto &rr : get_instances())
-            rr_instances.emplace(static_cast<riddle::complex_item *>(rr.operator->()), std::vector<atom *>());
+            rr_instances.emplace(static_cast<riddle::complex_item *>(rr.operator->()), std::vector<const atom_record *>());
 
-        for (const auto &atm : atoms)
-            if (get_solver().get_sat_core().value(atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
+        for (const auto &a_rec : atoms)
+            if (get_solver().get_sat_core().value(a_rec.atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
             {
-                const auto rr = atm->get(TAU_KW); // we get the reusable-resource..
-                if (auto enum_scope = dynamic_cast<enum_item *>(rr.operator->()))
+                const auto &rr = a_rec.tau; // we get the reusable-resource..
+                if (const auto enum_scope = a_rec.tau_enum)
                 { // the `tau` parameter is a variable..
                     for (const auto &rr_val : get_solver().get_ov_theory().value(enum_scope->get_var()))
-                        rr_instances.at(static_cast<riddle::complex_item *>(rr_val)).emplace_back(atm);
+                        rr_instances.at(static_cast<riddle::complex_item *>(rr_val)).emplace_back(&a_rec);
                 }
                 else // the `tau` parameter is a constant..
-                    rr_instances.at(static_cast<riddle::complex_item *>(rr.operator->())).emplace_back(atm);
+                    rr_instances.at(static_cast<riddle::complex_item *>(rr.operator->())).emplace_back(&a_rec);
             }
 
         for (const auto &[rr, atms] : rr_instances)
@@ -344,16 +353,16 @@ namespace ratio
             tl["capacity"] = to_json(c_capacity);
 
             // for each pulse, the atoms starting at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> starting_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> starting_atoms;
             // for each pulse, the atoms ending at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> ending_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> ending_atoms;
             // all the pulses of the timeline..
             std::set<utils::inf_rational> pulses;
 
             for (const auto &atm : atms)
             {
-                const auto start = get_solver().arith_value(atm->get(RATIO_START));
-                const auto end = get_solver().arith_value(atm->get(RATIO_END));
+                const auto start = get_solver().arith_value(atm->start);
+                const auto end = get_solver().arith_value(atm->end);
                 starting_atoms[start].insert(atm);
                 ending_atoms[end].insert(atm);
                 pulses.insert(start);
@@ -362,7 +371,7 @@ namespace ratio
             pulses.insert(get_solver().arith_value(get_solver().get("origin")));
             pulses.insert(get_solver().arith_value(get_solver().get("horizon")));
 
-            std::set<atom *> overlapping_atoms;
+            std::set<const atom_record *> overlapping_atoms;
             std::set<utils::inf_rational>::iterator p = pulses.begin();
             if (const auto at_start_p = starting_atoms.find(*p); at_start_p != starting_atoms.cend())
                 overlapping_atoms.insert(at_start_p->second.cbegin(), at_start_p->second.cend());
@@ -381,8 +390,8 @@ namespace ratio
                 utils::inf_rational c_usage; // the concurrent resource usage..
                 for (const auto &atm : overlapping_atoms)
                 {
-                    c_usage += get_solver().arith_value(atm->get(REUSABLE_RESOURCE_AMOUNT_NAME));
-                    j_atms.push_back(get_id(*atm));
+                    c_usage += get_solver().arith_value(atm->amount);
+                    j_atms.push_back(get_id(*atm->atm));
                 }
                 j_val["atoms"] = std::move(j_atms);
                 j_val["usage"] = to_json(c_usage);
@@ -11,35 +11,35 @@ namespace ratio
     {
         std::vector<std::vector<std::pair<semitone::lit, double>>> incs;
         // we partition atoms for each state-variable they might insist on..
-        std::unordered_map<const riddle::complex_item *, std::vector<atom *>> sv_instances;
-        for (const auto &atm : atoms)
-            if (get_solver().get_sat_core().value(atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
+        std::unordered_map<const riddle::complex_item *, std::vector<const atom_record *>> sv_instances;
+        for (const auto &a_rec : atoms)
+            if (get_solver().get_sat_core().value(a_rec.atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
             {
-                const auto sv = atm->get(TAU_KW); // we get the state-variable..
-                if (auto enum_scope = dynamic_cast<enum_item *>(sv.operator->()))
+                const auto &sv = a_rec.tau; // we get the state-variable..
+                if (const auto enum_scope = a_rec.tau_enum)
                 { // the `tau` parameter is a variable..
                     for (const auto &sv_val : get_solver().get_ov_theory().value(enum_scope->get_var()))
                         if (to_check.count(static_cast<const riddle::complex_item *>(sv_val))) // we consider only those state-variables which are still to be checked..
-                            sv_instances[static_cast<const riddle::complex_item *>(sv_val)].emplace_back(atm);
+                            sv_instances[static_cast<const riddle::complex_item *>(sv_val)].emplace_back(&a_rec);
                 }
                 else if (to_check.count(static_cast<riddle::complex_item *>(sv.operator->()))) // we consider only those state-variables which are still to be checked..
-                    sv_instances[static_cast<riddle::complex_item *>(sv.operator->())].emplace_back(atm);
+                    sv_instances[static_cast<riddle::complex_item *>(sv.operator->())].emplace_back(&a_rec);
             }
 
         // we detect inconsistencies for each of the state-variable instances..
         for ([[maybe_unused]] const auto &[sv, atms] : sv_instances)
         {
             // for each pulse, the atoms starting at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> starting_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> starting_atoms;
             // for each pulse, the atoms ending at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> ending_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> ending_atoms;
             // all the pulses of the timeline..
             std::set<utils::inf_rational> pulses;
 
             for (const auto &atm : atms)
             {
-                const auto start = get_solver().arith_value(atm->get(RATIO_START));
-                const auto end = get_solver().arith_value(atm->get(RATIO_END));
+                const auto start = get_solver().arith_value(atm->start);
+                const auto end = get_solver().arith_value(atm->end);
                 starting_atoms[start].insert(atm);
                 ending_atoms[end].insert(atm);
                 pulses.insert(start);
@@ -47,7 +47,7 @@ namespace ratio
             }
 
             bool has_conflict = false;
-            std::set<atom *> overlapping_atoms;
+            std::set<const atom_record *> overlapping_atoms;
             for (const auto &p : pulses)
             {
                 if (const auto at_start_p = starting_atoms.find(p); at_start_p != starting_atoms.cend())
@@ -61,9 +61,9 @@ namespace ratio
                     has_conflict = true;
                     std::vector<std::pair<semitone::lit, double>> choices;
                     std::unordered_set<semitone::var> vars;
-                    for (const auto &as : utils::combinations(std::vector<atom *>(overlapping_atoms.cbegin(), overlapping_atoms.cend()), 2))
+                    for (const auto &as : utils::combinations(std::vector<const atom_record *>(overlapping_atoms.cbegin(), overlapping_atoms.cend()), 2))
                     { // state-variable MCSs are made of two atoms..
-                        std::set<atom *> mcs(as.cbegin(), as.cend());
+                        std::set<atom *> mcs{as[0]->atm, as[1]->atm};
                         if (!sv_flaws.count(mcs))
                         { // we create a new state-variable flaw..
                             auto flw = new sv_flaw(*this, mcs);
@@ -71,13 +71,13 @@ namespace ratio
                             store_flaw(flw); // we store the flaw for retrieval when at root-level..
                         }
 
-                        const auto a0_start = as[0]->get(RATIO_START);
-                        const auto a0_end = as[0]->get(RATIO_END);
-                        const auto a1_start = as[1]->get(RATIO_START);
-                        const auto a1_end = as[1]->get(RATIO_END);
+                        const auto &a0_start = as[0]->start;
+                        const auto &a0_end = as[0]->end;
+                        const auto &a1_start = as[1]->start;
+                        const auto &a1_end = as[1]->end;
 
-                        if (auto a0_it = leqs.find(as[0]); a0_it != leqs.cend())
-                            if (auto a0_a1_it = a0_it->second.find(as[1]); a0_a1_it != a0_it->second.cend())
+                        if (auto a0_it = leqs.find(as[0]->atm); a0_it != leqs.cend())
+                            if (auto a0_a1_it = a0_it->second.find(as[1]->atm); a0_a1_it != a0_it->second.cend())
                                 if (get_solver().get_sat_core().value(a0_a1_it->second) == utils::Undefined && vars.insert(variable(a0_a1_it->second)).second)
                                 {
 #ifdef DL_TN
@@ -90,8 +90,8 @@ namespace ratio
                                     choices.emplace_back(a0_a1_it->second, commit);
                                 }
 
-                        if (auto a1_it = leqs.find(as[1]); a1_it != leqs.cend())
-                            if (auto a1_a0_it = a1_it->second.find(as[0]); a1_a0_it != a1_it->second.cend())
+                        if (auto a1_it = leqs.find(as[1]->atm); a1_it != leqs.cend())
+                            if (auto a1_a0_it = a1_it->second.find(as[0]->atm); a1_a0_it != a1_it->second.cend())
                                 if (get_solver().get_sat_core().value(a1_a0_it->second) == utils::Undefined && vars.insert(variable(a1_a0_it->second)).second)
                                 {
 #ifdef DL_TN
@@ -105,7 +105,7 @@ namespace ratio
                                 }
 
                         for (const auto atm : as)
-                            if (auto atm_frbs = frbs.find(atm); atm_frbs != frbs.cend())
+                            if (auto atm_frbs = frbs.find(atm->atm); atm_frbs != frbs.cend())
                             {
                                 auto nr_possible_frbs = std::count_if(atm_frbs->second.cbegin(), atm_frbs->second.cend(), [&](const auto &atm_sv)
                                                                       { return get_solver().get_sat_core().value(atm_sv.second) == utils::Undefined; });
@@ -140,25 +140,25 @@ namespace ratio
         const auto start = atm.get(RATIO_START);
         const auto end = atm.get(RATIO_END);
 
-        for (const auto &c_atm : atoms)
+        for (const auto &c_rec : atoms)
         {
-            const auto c_start = c_atm->get(RATIO_START);
-            const auto c_end = c_atm->get(RATIO_END);
+            const auto &c_start = c_rec.start;
+            const auto &c_end = c_rec.end;
 
 #ifdef DL_TN
-            auto atm_before = get_solver().get_rdl_theory().new_leq(static_cast<arith_item &>(*end).get_lin(), static_cast<arith_item &>(*c_start).get_lin());
-            auto atm_after = get_solver().get_rdl_theory().new_leq(static_cast<arith_item &>(*c_end).get_lin(), static_cast<arith_item &>(*start).get_lin());
+            auto atm_before = get_solver().new_leq(end, c_start, true);
+            auto atm_after = get_solver().new_leq(c_end, start, true);
 #elif LA_TN
-            auto atm_before = get_solver().get_lra_theory().new_leq(static_cast<arith_item &>(*end).get_lin(), static_cast<arith_item &>(*c_start).get_lin());
-            auto atm_after = get_solver().get_lra_theory().new_leq(static_cast<arith_item &>(*c_end).get_lin(), static_cast<arith_item &>(*start).get_lin());
+            auto atm_before = get_solver().new_leq(end, c_start, false);
+            auto atm_after = get_solver().new_leq(c_end, start, false);
             // we boost propagation..
             [[maybe_unused]] bool nc = get_solver().get_sat_core().new_clause({!atm_before, !atm_after});
             assert(nc);
 #endif
             if (get_solver().get_sat_core().value(atm_before) == utils::Undefined)
-                leqs[&atm][c_atm] = atm_before;
+                leqs[&atm][c_rec.atm] = atm_before;
             if (get_solver().get_sat_core().value(atm_after) == utils::Undefined)
-                leqs[c_atm][&atm] = atm_after;
+                leqs[c_rec.atm][&atm] = atm_after;
         }
 
         const auto tau = atm.get(TAU_KW);
@@ -170,7 +170,7 @@ namespace ratio
                     frbs[&atm][dynamic_cast<riddle::item *>(sv)] = !var;
             }
 
-        atoms.emplace_back(&atm);
+        atoms.emplace_back(atm, start, end, tau);
         // we store, for the atom, its atom listener..
         listeners.emplace_back(new sv_atom_listener(*this, atm));
 
@@ -246,21 +246,21 @@ namespace ratio
     {
         json::json tls(json::json_type::array);
         // we partition atoms for each state-variable they might insist on..
-        std::unordered_map<const riddle::complex_item *, std::vector<atom *>> sv_instances;
+        std::unordered_map<const riddle::complex_item *, std::vector<const atom_record *>> sv_instances;
         for (const auto &sv : get_instances())
-            sv_instances.emplace(static_cast<riddle::complex_item *>(sv.operator->()), std::vector<atom *>());
+            sv_instances.emplace(static_cast<riddle::complex_item *>(sv.operator->()), std::vector<const atom_record *>());
 
-        for (const auto &atm : atoms)
-            if (get_solver().get_sat_core().value(atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
+        for (const auto &a_rec : atoms)
+            if (get_solver().get_sat_core().value(a_rec.atm->get_sigma()) == utils::True) // we filter out those atoms which are not strictly active..
             {
-                const auto sv = atm->get(TAU_KW); // we get the state-variable..
-                if (auto enum_scope = dynamic_cast<enum_item *>(sv.operator->()))
+                const auto &sv = a_rec.tau; // we get the state-variable..
+                if (const auto enum_scope = a_rec.tau_enum)
                 { // the `tau` parameter is a variable..
                     for (const auto &sv_val : get_solver().get_ov_theory().value(enum_scope->get_var()))
-                        sv_instances.at(static_cast<const riddle::complex_item *>(sv_val)).emplace_back(atm);
+                        sv_instances.at(static_cast<const riddle::complex_item *>(sv_val)).emplace_back(&a_rec);
                 }
                 else // the `tau` parameter is a constant..
-                    sv_instances.at(static_cast<riddle::complex_item *>(sv.operator->())).emplace_back(atm);
+                    sv_instances.at(static_cast<riddle::complex_item *>(sv.operator->())).emplace_back(&a_rec);
             }
 
         for (const auto &[sv, atms] : sv_instances)
@@ -271,16 +271,16 @@ namespace ratio
 #endif
 
             // for each pulse, the atoms starting at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> starting_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> starting_atoms;
             // for each pulse, the atoms ending at that pulse..
-            std::map<utils::inf_rational, std::set<atom *>> ending_atoms;
+            std::map<utils::inf_rational, std::set<const atom_record *>> ending_atoms;
             // all the pulses of the timeline..
             std::set<utils::inf_rational> pulses;
 
             for (const auto &atm : atms)
             {
-                const auto start = get_solver().arith_value(atm->get(RATIO_START));
-                const auto end = get_solver().arith_value(atm->get(RATIO_END));
+                const auto start = get_solver().arith_value(atm->start);
+                const auto end = get_solver().arith_value(atm->end);
                 starting_atoms[start].insert(atm);
                 ending_atoms[end].insert(atm);
                 pulses.insert(start);
@@ -289,7 +289,7 @@ namespace ratio
             pulses.insert(get_solver().arith_value(get_solver().get("origin")));
             pulses.insert(get_solver().arith_value(get_solver().get("horizon")));
 
-            std::set<atom *> overlapping_atoms;
+            std::set<const atom_record *> overlapping_atoms;
             std::set<utils::inf_rational>::iterator p = pulses.begin();
             if (const auto at_start_p = starting_atoms.find(*p); at_start_p != starting_atoms.cend())
                 overlapping_atoms.insert(at_start_p->second.cbegin(), at_start_p->second.cend());
@@ -304,7 +304,7 @@ namespace ratio
 
                 json::json j_atms(json::json_type::array);
                 for (const auto &atm : overlapping_atoms)
-                    j_atms.push_back(get_id(*atm));
+                    j_atms.push_back(get_id(*atm->atm));
                 j_val["atoms"] = std::move(j_atms);
                 j_vals.push_back(std::move(j_val));
 
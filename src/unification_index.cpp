@@ -0,0 +1,174 @@
+#include "unification_index.h"
+#include "solver.h"
+#include <queue>
+#include <cassert>
+
+namespace ratio
+{
+    unification_index::unification_index(solver &s) : slv(s) {}
+
+    std::vector<atom *> unification_index::get_candidates(atom &atm)
+    {
+        auto &p_idx = get_index(static_cast<riddle::predicate &>(atm.get_type()));
+
+        // we look for the most selective indexed argument of the atom..
+        std::vector<size_t> c_pos;
+        size_t c_size = p_idx.atoms.size();
+        bool selected = false;
+        for (size_t i = 0; i < p_idx.keys.size(); ++i)
+        {
+            auto vals = get_values(atm.get(p_idx.keys[i]));
+            if (vals.empty())
+                continue; // we cannot use this argument for selecting the candidates..
+            size_t size = p_idx.wildcards[i].size();
+            for (const auto &v : vals)
+                if (auto b_it = p_idx.buckets[i].find(v); b_it != p_idx.buckets[i].cend())
+                    size += b_it->second.size();
+            if (size < c_size || !selected)
+            { // we found a more selective argument..
+                c_pos.clear();
+                c_pos.reserve(size);
+                for (const auto &v : vals)
+                    if (auto b_it = p_idx.buckets[i].find(v); b_it != p_idx.buckets[i].cend())
+                        c_pos.insert(c_pos.cend(), b_it->second.cbegin(), b_it->second.cend());
+                c_pos.insert(c_pos.cend(), p_idx.wildcards[i].cbegin(), p_idx.wildcards[i].cend());
+                c_size = size;
+                selected = true;
+            }
+        }
+
+        if (selected)
+        { // we restore the creation order of the candidates, removing duplicates..
+            std::sort(c_pos.begin(), c_pos.end());
+            c_pos.erase(std::unique(c_pos.begin(), c_pos.end()), c_pos.end());
+        }
+        else
+        { // no argument can be used for selecting the candidates, hence all the atoms are candidates..
+            c_pos.resize(p_idx.atoms.size());
+            for (size_t i = 0; i < c_pos.size(); ++i)
+                c_pos[i] = i;
+        }
+
+        std::vector<atom *> candidates;
+        candidates.reserve(c_pos.size());
+        if (p_idx.time_key.empty())
+            for (const auto &pos : c_pos)
+                candidates.push_back(p_idx.atoms[pos]);
+        else
+        { // we filter out the atoms that cannot overlap in time with the current atom..
+            const auto [lb, ub] = get_bounds(atm.get(p_idx.time_key));
+            for (const auto &pos : c_pos)
+                if (p_idx.bounds[pos].second >= lb && p_idx.bounds[pos].first <= ub)
+                    candidates.push_back(p_idx.atoms[pos]);
+        }
+        return candidates;
+    }
+
+    void unification_index::rank(atom &atm, std::vector<atom *> &targets)
+    {
+        const auto &p_idx = get_index(static_cast<riddle::predicate &>(atm.get_type()));
+        if (p_idx.time_key.empty())
+            return; // we have no ranking criterion, hence we keep the current order..
+
+        const auto lb = get_bounds(atm.get(p_idx.time_key)).first;
+        std::vector<std::pair<utils::inf_rational, atom *>> dists; // the temporal distances of the targets from the atom..
+        dists.reserve(targets.size());
+        for (const auto &t_atm : targets)
+        {
+            const auto t_lb = get_bounds(t_atm->get(p_idx.time_key)).first;
+            if (is_infinite(lb) || is_infinite(t_lb))
+                dists.emplace_back(utils::rational::POSITIVE_INFINITY, t_atm);
+            else
+                dists.emplace_back(t_lb < lb ? lb - t_lb : t_lb - lb, t_atm);
+        }
+        std::stable_sort(dists.begin(), dists.end(), [](const auto &d0, const auto &d1)
+                         { return d0.first < d1.first; });
+        for (size_t i = 0; i < dists.size(); ++i)
+            targets[i] = dists[i].second;
+    }
+
+    unification_index::predicate_index &unification_index::get_index(const riddle::predicate &pred)
+    {
+        auto [p_it, added] = indexes.try_emplace(&pred);
+        auto &p_idx = p_it->second;
+        if (added)
+        { // we collect the arguments to index (i.e., the non-synthetic enumerable ones, the same compared by `solver::matches`)..
+            std::queue<const riddle::predicate *> q;
+            q.push(&pred);
+            while (!q.empty())
+            {
+                for (const auto &[f_name, f] : q.front()->get_fields())
+                    if (!f->is_synthetic() && !f->get_type().is_primitive())
+                        p_idx.keys.push_back(f_name);
+                for (const auto &stp : q.front()->get_parents())
+                    q.push(&stp.get());
+                q.pop();
+            }
+            p_idx.buckets.resize(p_idx.keys.size());
+            p_idx.wildcards.resize(p_idx.keys.size());
+
+            if (slv.is_interval(pred))
+                p_idx.time_key = RATIO_START;
+            else if (slv.is_impulse(pred))
+                p_idx.time_key = RATIO_AT;
+        }
+
+        // we index the atoms created since the last update..
+        const auto &instances = pred.get_instances();
+        for (; p_idx.n_instances < instances.size(); ++p_idx.n_instances)
+            add_atom(p_idx, static_cast<atom &>(*instances[p_idx.n_instances]));
+        return p_idx;
+    }
+
+    void unification_index::add_atom(predicate_index &p_idx, atom &atm)
+    {
+        const size_t pos = p_idx.atoms.size();
+        p_idx.atoms.push_back(&atm);
+
+        // values and bounds can only shrink at root level, hence, if we are not at root level, we cannot record them..
+        const bool root_level = slv.get_sat_core().root_level();
+        for (size_t i = 0; i < p_idx.keys.size(); ++i)
+        {
+            auto vals = root_level ? get_values(atm.get(p_idx.keys[i])) : std::vector<const utils::enum_val *>();
+            if (vals.empty())
+                p_idx.wildcards[i].push_back(pos);
+            else
+                for (const auto &v : vals)
+                    p_idx.buckets[i][v].push_back(pos);
+        }
+
+        if (!p_idx.time_key.empty())
+        {
+            if (root_level)
+                p_idx.bounds.push_back(get_bounds(atm.get(p_idx.time_key)));
+            else
+                p_idx.bounds.emplace_back(utils::rational::NEGATIVE_INFINITY, utils::rational::POSITIVE_INFINITY);
+        }
+    }
+
+    std::vector<const utils::enum_val *> unification_index::get_values(const riddle::expr &xpr) const noexcept
+    {
+        switch (slv.get_kind(*xpr))
+        {
+        case enum_kind:
+        {
+            auto vals = slv.get_ov_theory().value(static_cast<enum_item &>(*xpr).get_var());
+            return std::vector<const utils::enum_val *>(vals.cbegin(), vals.cend());
+        }
+        case complex_kind:
+            if (auto ev = dynamic_cast<const utils::enum_val *>(xpr.operator->()))
+                return {ev};
+            return {};
+        default: // primitive items (including strings, which are compared by value) cannot be used as keys..
+            return {};
+        }
+    }
+
+    std::pair<utils::inf_rational, utils::inf_rational> unification_index::get_bounds(const riddle::expr &xpr) const noexcept
+    {
+        if (xpr->get_type() == slv.get_time_type())
+            return slv.time_bounds(xpr);
+        else
+            return slv.arith_bounds(xpr);
+    }
+} // namespace ratio
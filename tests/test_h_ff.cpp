@@ -0,0 +1,51 @@
+#include "solver.h"
+#include "atom_flaw.h"
+#include <cassert>
+
+void test_shared_subgoals()
+{
+    // we create a solver
+    ratio::solver s;
+
+    // the `Task1` task can either share the `Shared` subgoal of the `Task0` task or pursue the (individually cheaper) `Private` subgoal
+    s.read(R"(
+predicate Shared() {
+    {} [5.0] or {} [5.0]
+}
+
+predicate Private() {}
+
+predicate Task0() {
+    goal s = new Shared();
+}
+
+predicate Task1() {
+    { goal s = new Shared(); } [1.0] or { goal p = new Private(); } [1.0]
+}
+
+goal t0 = new Task0();
+goal t1 = new Task1();
+)");
+
+    // we solve the problem
+    auto res = s.solve();
+    assert(res);
+
+    // the relaxed plans count the shared subgoal once, hence the `Private` subgoal is discarded..
+    for (const auto &p : s.get_predicate("Private").get_instances())
+        assert(s.get_sat_core().value(static_cast<ratio::atom &>(*p).get_reason().get_phi()) == utils::False);
+
+    // ..and the `Shared` subgoal is achieved once
+    size_t n_active = 0;
+    for (const auto &sh : s.get_predicate("Shared").get_instances())
+        if (s.get_sat_core().value(static_cast<ratio::atom &>(*sh).get_sigma()) == utils::True)
+            ++n_active;
+    assert(n_active == 1);
+}
+
+int main(int argc, char const *argv[])
+{
+    test_shared_subgoals();
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "topological_order.h"
+#include <random>
+#include <tuple>
+#include <set>
+#include <algorithm>
+#include <cassert>
+
+using edge = std::tuple<size_t, size_t, ratio::resolver *>;
+
+// checks, by visiting the given edges, whether the `to` node is reachable from the `from` node
+bool reaches(const std::multiset<edge> &edges, const size_t &n_nodes, const size_t &from, const size_t &to)
+{
+    std::vector<bool> visited(n_nodes, false);
+    std::vector<size_t> q{from};
+    while (!q.empty())
+    {
+        const auto n = q.back();
+        q.pop_back();
+        if (n == to)
+            return true;
+        if (visited[n])
+            continue;
+        visited[n] = true;
+        for (const auto &[e_from, e_to, e_r] : edges)
+            if (e_from == n)
+                q.push_back(e_to);
+    }
+    return false;
+}
+
+void test_random_edges()
+{
+    // the labels of the edges (which are never dereferenced)
+    char labels[3];
+    std::mt19937 gen(42);
+    for (size_t i = 0; i < 300; ++i)
+    {
+        ratio::topological_order t_ord;
+        const size_t n_nodes = 3 + gen() % 25;
+        for (size_t n = 0; n < n_nodes; ++n)
+            assert(t_ord.new_node() == n);
+
+        std::multiset<edge> edges;
+        for (size_t j = 0; j < 200; ++j)
+        {
+            if (gen() % 4 == 0 && !edges.empty())
+            { // we remove a random edge
+                const auto e_it = std::next(edges.begin(), gen() % edges.size());
+                t_ord.remove_edge(std::get<0>(*e_it), std::get<1>(*e_it), std::get<2>(*e_it));
+                edges.erase(e_it);
+                continue;
+            }
+
+            // we add a random edge, which must be rejected if and only if it closes a cycle
+            const size_t from = gen() % n_nodes, to = gen() % n_nodes;
+            auto r = reinterpret_cast<ratio::resolver *>(&labels[gen() % 3]);
+            std::vector<ratio::resolver *> cycle;
+            const bool added = t_ord.add_edge(from, to, r, cycle);
+            assert(added != reaches(edges, n_nodes, to, from));
+            if (added)
+                edges.emplace(from, to, r);
+            else // the cycle is made of the edge and of existing edges
+                for (const auto &c_r : cycle)
+                    assert(c_r == r || std::any_of(edges.cbegin(), edges.cend(), [&c_r](const auto &e)
+                                                   { return std::get<2>(e) == c_r; }));
+
+            // the order agrees with all the edges
+            for (const auto &[e_from, e_to, e_r] : edges)
+                assert(t_ord.position(e_from) < t_ord.position(e_to));
+
+            // the reachability agrees with the edges
+            const size_t n0 = gen() % n_nodes, n1 = gen() % n_nodes;
+            assert(t_ord.reaches(n0, n1) == reaches(edges, n_nodes, n0, n1));
+        }
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    test_random_edges();
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "solver.h"
+#include <algorithm>
+#include <cassert>
+
+void test_unification_index()
+{
+    // we create a solver
+    ratio::solver s;
+
+    // we create some atoms, either with constant or with variable arguments
+    s.read(R"(
+class Location {}
+
+Location l0 = new Location();
+Location l1 = new Location();
+Location l2 = new Location();
+
+class Robot : StateVariable
+{
+    predicate At(Location l) { duration >= 1.0; }
+}
+
+Robot r0 = new Robot();
+Robot r1 = new Robot();
+
+fact f0 = new r0.At(l:l0, start:0.0, end:5.0);
+fact f1 = new r1.At(l:l1, start:0.0, end:5.0);
+fact f2 = new r0.At(l:l1, start:10.0, end:15.0);
+fact f3 = new r1.At(l:l0, start:20.0, end:25.0);
+
+goal g0 = new r0.At(l:l0);
+goal g1 = new r1.At(l:l1, end:5.0);
+goal g2 = new r0.At(start:12.0);
+goal g3 = new r1.At(l:l2);
+)");
+
+    // the candidates returned by the index must include all the atoms returned by a linear scan filtered by `matches`
+    ratio::unification_index idx(s);
+    size_t n_atoms = 0, n_candidates = 0;
+    for (const auto &t : s.get_types())
+        if (auto ct = dynamic_cast<riddle::complex_type *>(&t.get()))
+            for (const auto &p : ct->get_predicates())
+            {
+                const auto &instances = p.get().get_instances();
+                for (const auto &i_atm : instances)
+                {
+                    auto &atm = static_cast<ratio::atom &>(*i_atm);
+                    auto candidates = idx.get_candidates(atm);
+
+                    // the candidates are instances of the predicate, sorted by their creation order
+                    std::vector<riddle::expr> c_instances;
+                    for (const auto &c_atm : candidates)
+                        c_instances.emplace_back(c_atm);
+                    auto i_it = instances.cbegin();
+                    for (const auto &c_atm : c_instances)
+                    {
+                        i_it = std::find(i_it, instances.cend(), c_atm);
+                        assert(i_it != instances.cend());
+                    }
+
+                    for (const auto &t_atm : instances)
+                        if (t_atm != i_atm && s.matches(i_atm, t_atm))
+                            assert(std::find(c_instances.cbegin(), c_instances.cend(), t_atm) != c_instances.cend());
+
+                    n_atoms += instances.size();
+                    n_candidates += candidates.size();
+                }
+            }
+
+    // the index actually filters the atoms with different locations or which cannot overlap in time
+    assert(n_candidates < n_atoms);
+}
+
+int main(int argc, char const *argv[])
+{
+    test_unification_index();
+
+    return 0;
+}